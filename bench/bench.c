@@ -0,0 +1,581 @@
+/**
+ * @file bench.c
+ * @brief Microbenchmarks of the task and history routines.
+ *
+ * Every benchmark prints one JSON object per line to stdout:
+ *
+ *      {"bench": "lines_views", "isa": "avx2", "history_mb": 0,
+ *       "ops": 2000000, "bytes": 40000000, "ns_per_op": 8.5,
+ *       "mb_per_s": 4483.0}
+ *
+ * History benchmarks run in a temporary directory over generated histories
+ * of the sizes given as arguments in megabytes, 1, 100 and 1024 by default.
+ * Histories span ten years from DATE_MIN_YEAR, so all of their months are
+ * closed and end up archived, as the history of a long-time user does.
+ *
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#include <dirent.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "date.h"
+#include "error.h"
+#include "history.h"
+#include "io.h"
+#include "lines.h"
+#include "scan.h"
+#include "store.h"
+#include "tasks.h"
+#include "types.h"
+
+/** Number of calls of the cheap routines. */
+#define BENCH_OPS      1000000L
+
+/** Number of tasks in the generated entry and in the large task list. */
+#define BENCH_TASKS    10000L
+
+/** Number of tasks appended by the task list benchmark. */
+#define BENCH_APPENDS  1000000L
+
+/** Number of tasks deleted from the middle of the large task list. */
+#define BENCH_DELETES  10000L
+
+/** Number of reads and writes of the generated entry. */
+#define BENCH_ENTRIES  200L
+
+/** Number of history days looked up. */
+#define BENCH_LOOKUPS  1000L
+
+/** Number of days the generated history spans. */
+#define BENCH_DAYS     3650L
+
+/** Template of the temporary directory. */
+#define BENCH_DIR      "/tmp/doit-bench-XXXXXX"
+
+/**
+ * @brief Type definition for the line counter of a history scan.
+ */
+typedef struct ScanCount_tag {
+        uint64_t tasks; ///< Number of tasks.
+        uint64_t bytes; ///< Number of subject bytes.
+} ScanCount;
+
+/**
+ * @brief Gets monotonic time in seconds.
+ */
+static double now(void);
+
+/**
+ * @brief Prints result as a JSON line.
+ */
+static void report(const char *name, long history_mb, uint64_t ops,
+                uint64_t bytes, double secs);
+
+/**
+ * @brief Gets next pseudo-random number.
+ */
+static uint32_t next_rand(void);
+
+/**
+ * @brief Writes task line with a made-up subject into @p line.
+ * @return Length of the line, including the newline.
+ */
+static int make_line(char *line, Date date, bool status);
+
+/**
+ * @brief Makes text entry of @p count tasks dated @p date.
+ * @return Pointer to the newly allocated text, or NULL on failure.
+ */
+static char *make_entry(long count, Date date, size_t *len);
+
+/**
+ * @brief Measures lines_split() with lines_views() and date_is_valid().
+ */
+static bool bench_parse(void);
+
+/**
+ * @brief Measures reading, serializing and storing entries.
+ */
+static bool bench_entry(void);
+
+/**
+ * @brief Measures appending, looking up and deleting tasks.
+ */
+static bool bench_tasks(void);
+
+/**
+ * @brief Measures history migration, day lookups and full scans.
+ */
+static bool bench_history(long size_mb);
+
+/**
+ * @brief Writes generated history.txt of about @p size bytes.
+ * @return Number of written bytes, or 0 on failure.
+ */
+static uint64_t make_history(uint64_t size);
+
+/**
+ * @brief Gets date of the history day @p day, counted from the first one.
+ */
+static Date history_day(long day);
+
+/**
+ * @brief Lets every task through.
+ */
+static bool keep_task(const TaskView *view, const void *arg);
+
+/**
+ * @brief Counts tasks and their subject bytes.
+ */
+static void count_task(const TaskView *view, void *arg);
+
+/**
+ * @brief Removes the files of a directory and the directory itself.
+ */
+static void remove_dir(const char *path);
+
+/** State of the pseudo-random generator. */
+static uint32_t rand_state = 2463534242u;
+
+/** Words subjects are made of. */
+static const char *words[] = {
+        "buy", "milk", "call", "mom", "fix", "bike", "read", "book", "pay",
+        "rent", "write", "report", "clean", "kitchen", "walk", "dog", "send",
+        "invoice", "plan", "trip", "review", "patch", "water", "plants"
+};
+
+int main(int argc, char *argv[])
+{
+        static const long default_sizes[] = { 1, 100, 1024 };
+        char dir[] = BENCH_DIR;
+        bool ok = true;
+
+        err_sink(ERR_SINK_STDERR, NULL);
+
+        if (mkdtemp(dir) == NULL || chdir(dir) < 0 || mkdir("txt", 0755) < 0) {
+                fprintf(stderr, "bench: can't prepare %s: %s\n", dir,
+                                CLEAN_ERRNO());
+                return EXIT_FAILURE;
+        }
+
+        ok = bench_parse() && bench_entry() && bench_tasks();
+
+        for (int i = 1; ok && i < (argc > 1 ? argc : 4); i++) {
+                long size_mb = argc > 1 ? strtol(argv[i], NULL, 10) :
+                        default_sizes[i - 1];
+
+                if (size_mb > 0)
+                        ok = bench_history(size_mb);
+        }
+
+        remove_dir(HISTORY_DIR);
+        rmdir("txt");
+
+        if (chdir("/") == 0)
+                rmdir(dir);
+
+        return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static double now(void)
+{
+        struct timespec ts;
+
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void report(const char *name, long history_mb, uint64_t ops,
+                uint64_t bytes, double secs)
+{
+        if (secs <= 0)
+                secs = 1e-9;
+
+        printf("{\"bench\": \"%s\", \"isa\": \"%s\", \"history_mb\": %ld, "
+                        "\"ops\": %" PRIu64 ", \"bytes\": %" PRIu64 ", "
+                        "\"ns_per_op\": %.1f, \"mb_per_s\": %.1f}\n",
+                        name, lines_isa(), history_mb, ops, bytes,
+                        ops ? secs * 1e9 / ops : 0.0,
+                        bytes / secs / (1024.0 * 1024.0));
+        fflush(stdout);
+}
+
+static uint32_t next_rand(void)
+{
+        rand_state ^= rand_state << 13;
+        rand_state ^= rand_state >> 17;
+        rand_state ^= rand_state << 5;
+        return rand_state;
+}
+
+static int make_line(char *line, Date date, bool status)
+{
+        size_t nwords = sizeof(words) / sizeof(words[0]);
+        int len = snprintf(line, LINESIZE, "%02u.%02u.%04u %c %s %s",
+                        (unsigned) DATE_DAY(date), (unsigned) DATE_MONTH(date),
+                        (unsigned) DATE_YEAR(date), status ? '+' : '-',
+                        words[next_rand() % nwords],
+                        words[next_rand() % nwords]);
+
+        /* Some subjects are longer, as real ones are. */
+        if (next_rand() % 4 == 0)
+                len += snprintf(line + len, LINESIZE - len, " %s",
+                                words[next_rand() % nwords]);
+
+        line[len++] = '\n';
+        line[len] = '\0';
+        return len;
+}
+
+static char *make_entry(long count, Date date, size_t *len)
+{
+        char *text = malloc(count * LINESIZE);
+
+        if (text == NULL)
+                return NULL;
+
+        *len = 0;
+
+        for (long i = 0; i < count; i++)
+                *len += make_line(text + *len, date, next_rand() % 2);
+
+        return text;
+}
+
+static bool bench_parse(void)
+{
+        size_t len = 0;
+        char *text = make_entry(BENCH_TASKS, DATE_PACK(17, 10, 2026), &len);
+
+        if (text == NULL) {
+                FAIL(ERR_NOMEM, "Out of memory.");
+                return false;
+        }
+
+        LineBatch batch;
+        TaskView views[LINES_BATCH];
+        bool valid[LINES_BATCH];
+        uint64_t lines = 0;
+
+        /* Lines go through the same calls read_entry_from_file() makes. */
+        double start = now();
+
+        for (long i = 0; i < BENCH_ENTRIES; i++) {
+                const char *pos = text;
+
+                while (lines_split(&pos, text + len, &batch) > 0)
+                        lines += lines_views(&batch, views, valid);
+        }
+
+        report("lines_views", 0, lines, (uint64_t) BENCH_ENTRIES * len,
+                        now() - start);
+        free(text);
+        text = NULL;
+
+        static const char *dates[] = {
+                "17.10.2026", "29.02.2024", "31.12.2059", "01.01.2016"
+        };
+        Date date = 0;
+
+        start = now();
+
+        for (long i = 0; i < BENCH_OPS; i++)
+                date_is_valid(dates[i & 3], &date);
+
+        report("date_is_valid", 0, BENCH_OPS,
+                        (uint64_t) BENCH_OPS * DATEOFFSET, now() - start);
+        return true;
+}
+
+static bool bench_entry(void)
+{
+        static const char *path = "txt/last_entry.bin";
+        static const EntryFormat formats[] = { ENTRY_TEXT, ENTRY_BINARY };
+        static const char *names[] = { "serialize_entry_text",
+                "serialize_entry_binary" };
+        size_t len = 0;
+        char *text = make_entry(BENCH_TASKS, DATE_PACK(17, 10, 2026), &len);
+
+        if (text == NULL) {
+                FAIL(ERR_NOMEM, "Out of memory.");
+                return false;
+        }
+
+        Tasks entry;
+        bool ok = true;
+
+        init_tasks(&entry);
+
+        double start = now();
+
+        for (long i = 0; ok && i < BENCH_ENTRIES; i++) {
+                FILE *fp = fmemopen(text, len, "r");
+
+                reset_tasks(&entry);
+                ok = fp != NULL && read_entry_from_file(fp, &entry);
+
+                if (fp)
+                        fclose(fp);
+        }
+
+        report("read_entry_from_file", 0, BENCH_ENTRIES,
+                        (uint64_t) BENCH_ENTRIES * len, now() - start);
+        free(text);
+        text = NULL;
+
+        for (int f = 0; ok && f < 2; f++) {
+                uint64_t bytes = 0;
+
+                start = now();
+
+                for (long i = 0; ok && i < BENCH_ENTRIES; i++) {
+                        char *data = serialize_entry(&entry, formats[f], &len);
+
+                        ok = data != NULL;
+                        bytes += len;
+                        free(data);
+                }
+
+                report(names[f], 0, BENCH_ENTRIES, bytes, now() - start);
+        }
+
+        /* Every store syncs, so it's measured with the disk under /tmp. */
+        start = now();
+
+        for (long i = 0; ok && i < BENCH_ENTRIES; i++)
+                ok = store_entry(path, &entry, ENTRY_BINARY);
+
+        report("store_entry", 0, BENCH_ENTRIES,
+                        (uint64_t) BENCH_ENTRIES * len, now() - start);
+
+        Tasks copy;
+
+        init_tasks(&copy);
+        start = now();
+
+        for (long i = 0; ok && i < BENCH_ENTRIES; i++) {
+                reset_tasks(&copy);
+                ok = read_entry(path, &copy);
+        }
+
+        report("read_entry", 0, BENCH_ENTRIES, (uint64_t) BENCH_ENTRIES * len,
+                        now() - start);
+        unlink(path);
+        destroy_tasks(&copy);
+        destroy_tasks(&entry);
+        return ok;
+}
+
+static bool bench_tasks(void)
+{
+        Tasks entry;
+        char line[LINESIZE] = { 0 };
+        bool ok = true;
+
+        init_tasks(&entry);
+        make_line(line, DATE_PACK(17, 10, 2026), false);
+        line[strlen(line) - 1] = '\0';
+
+        double start = now();
+
+        for (long i = 0; ok && i < BENCH_APPENDS; i++)
+                ok = add_task(&entry, line + SUBJOFFSET, false);
+
+        report("add_task", 0, BENCH_APPENDS, 0, now() - start);
+
+        /* Random access by index took a list walk before tasks were arrays. */
+        uint64_t bytes = 0;
+
+        start = now();
+
+        for (long i = 0; ok && i < BENCH_OPS; i++) {
+                long index = next_rand() % tasks_size(&entry) + 1;
+
+                bytes += strlen(task_subject(&entry, index));
+        }
+
+        report("task_lookup", 0, BENCH_OPS, bytes, now() - start);
+
+        reset_tasks(&entry);
+
+        for (long i = 0; ok && i < BENCH_TASKS * 10; i++)
+                ok = add_task(&entry, line + SUBJOFFSET, false);
+
+        start = now();
+
+        for (long i = 0; ok && i < BENCH_DELETES; i++)
+                ok = delete_task(&entry, tasks_size(&entry) / 2 + 1);
+
+        report("delete_task", 0, BENCH_DELETES, 0, now() - start);
+
+        destroy_tasks(&entry);
+        return ok;
+}
+
+static bool bench_history(long size_mb)
+{
+        double start = now();
+        uint64_t size = make_history((uint64_t) size_mb * 1024 * 1024);
+
+        if (size == 0)
+                return false;
+
+        report("make_history", size_mb, 1, size, now() - start);
+
+        Manifest man;
+
+        start = now();
+
+        if (!history_open(&man)) {
+                WARNING("Failed to open history.");
+                return false;
+        }
+
+        report("history_open", size_mb, 1, size, now() - start);
+
+        /* Lookups are what search_history() does after asking for a date. */
+        uint64_t bytes = 0;
+        bool ok = true;
+
+        start = now();
+
+        for (long i = 0; ok && i < BENCH_LOOKUPS; i++) {
+                char *buf = NULL;
+                size_t len = 0;
+
+                ok = history_read_day(&man, history_day(next_rand() %
+                                        BENCH_DAYS), &buf, &len);
+                bytes += len;
+                free(buf);
+                buf = NULL;
+        }
+
+        report("history_read_day", size_mb, BENCH_LOOKUPS, bytes,
+                        now() - start);
+
+        ScanCount count = { 0, 0 };
+
+        start = now();
+        ok = ok && scan_history(&man, 0, UINT32_MAX, keep_task, NULL,
+                        count_task, &count);
+        report("scan_history", size_mb, count.tasks, size, now() - start);
+
+        ok = history_erase(&man) && ok;
+        history_close(&man);
+        return ok;
+}
+
+static uint64_t make_history(uint64_t size)
+{
+        FILE *fp = fopen(HISTORY, "w");
+
+        if (fp == NULL) {
+                FAIL(ERR_IO, "Failed to create history.");
+                return 0;
+        }
+
+        uint64_t written = 0;
+        char line[LINESIZE] = { 0 };
+
+        /* Days get equal shares of the size, whatever lines are made. */
+        for (long day = 0; day < BENCH_DAYS; day++) {
+                Date date = history_day(day);
+                uint64_t share = size * (day + 1) / BENCH_DAYS;
+
+                while (written < share) {
+                        int len = make_line(line, date, next_rand() % 2);
+
+                        if (fwrite(line, 1, len, fp) != (size_t) len) {
+                                FAIL(ERR_IO, "Failed to write history.");
+                                fclose(fp);
+                                return 0;
+                        }
+
+                        written += len;
+                }
+        }
+
+        if (fclose(fp) != 0) {
+                FAIL(ERR_IO, "Failed to write history.");
+                return 0;
+        }
+
+        return written;
+}
+
+static Date history_day(long day)
+{
+        unsigned d = 1, m = 1, y = DATE_MIN_YEAR;
+        Date date = 0;
+
+        /* Day is counted through whole years first, then month by month. */
+        for (;;) {
+                long year_days = date_make(29, 2, y, &date) ? 366 : 365;
+
+                if (day < year_days)
+                        break;
+
+                day -= year_days;
+                ++y;
+        }
+
+        while (day > 0) {
+                if (date_make(d + 1, m, y, &date)) {
+                        ++d;
+                } else {
+                        d = 1;
+                        ++m;
+                }
+
+                --day;
+        }
+
+        date_make(d, m, y, &date);
+        return date;
+}
+
+static bool keep_task(const TaskView *view, const void *arg)
+{
+        (void) view;
+        (void) arg;
+        return true;
+}
+
+static void count_task(const TaskView *view, void *arg)
+{
+        ScanCount *count = arg;
+
+        ++count->tasks;
+        count->bytes += view->subj_len;
+}
+
+static void remove_dir(const char *path)
+{
+        DIR *dir = opendir(path);
+
+        if (dir == NULL)
+                return;
+
+        struct dirent *ent = NULL;
+        char name[SEGMENT_PATHSIZE + 256];
+
+        while ((ent = readdir(dir)) != NULL) {
+                if (STRCMP(ent->d_name, ==, ".") ||
+                                STRCMP(ent->d_name, ==, ".."))
+                        continue;
+
+                snprintf(name, sizeof(name), "%s/%s", path, ent->d_name);
+                unlink(name);
+        }
+
+        closedir(dir);
+        rmdir(path);
+}
@@ -0,0 +1,350 @@
+/**
+ * @file archive.c
+ * @brief Function definitions for block-compressed history archives.
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "archive.h"
+#include "date.h"
+#include "error.h"
+#include "history.h"
+#include "lz.h"
+#include "mapfile.h"
+#include "store.h"
+
+/**
+ * @brief Checks archive header and block table.
+ * @param[in] map Pointer to the read-only mapping of the archive.
+ * @return True if the archive is consistent, or false otherwise.
+ */
+static bool check_archive(const MapFile *map);
+
+/**
+ * @brief Compresses lines into a new archive image.
+ * @param[in] raw Lines which are to be archived.
+ * @param[in] raw_size Size of the lines in bytes.
+ * @param[in] merged_hash Hash of the merged segment file.
+ * @param[in,out] len Pointer, where the image length is to be stored.
+ * @return Pointer to the newly allocated image, or NULL on failure.
+ */
+static char *build_archive(const char *raw, size_t raw_size,
+                uint64_t merged_hash, size_t *len);
+
+bool archive_segment(Date month)
+{
+        char txt_path[SEGMENT_PATHSIZE] = { 0 };
+        char idx_path[SEGMENT_PATHSIZE] = { 0 };
+        char dz_path[SEGMENT_PATHSIZE] = { 0 };
+        char pack_path[SEGMENT_PATHSIZE] = { 0 };
+
+        segment_path(month, SEGMENT_TEXT, txt_path);
+        segment_path(month, SEGMENT_INDEX, idx_path);
+        segment_path(month, SEGMENT_ARCHIVE, dz_path);
+        segment_path(month, SEGMENT_PACKING, pack_path);
+
+        /* Unfinished merge is finished before a new one starts. */
+        if (access(pack_path, F_OK) != 0) {
+                if (access(txt_path, F_OK) != 0)
+                        return true;
+
+                if (rename(txt_path, pack_path) < 0) {
+                        FAIL(ERR_IO, "Failed to rename history segment.");
+                        return false;
+                }
+        }
+
+        unlink(idx_path);
+
+        MapFile pack = { NULL, 0 };
+        MapFile old = { NULL, 0 };
+
+        if (!map_file(pack_path, &pack)) {
+                FAIL(ERR_IO, "Failed to map history segment.");
+                return false;
+        }
+
+        uint64_t hash = store_hash(pack.data, pack.size);
+        bool merged = pack.size == 0;
+
+        if (!merged && map_file(dz_path, &old) && check_archive(&old)) {
+                ArchiveHdr hdr;
+
+                memcpy(&hdr, old.data, sizeof(ArchiveHdr));
+                merged = hdr.merged_hash == hash;
+        }
+
+        unmap_file(&old);
+
+        char *raw = NULL;
+        size_t raw_size = 0;
+        bool ok = merged || archive_read(month, 0, &raw, &raw_size);
+
+        if (ok && !merged) {
+                char *tmp = realloc(raw, raw_size + pack.size);
+
+                ok = tmp != NULL;
+
+                if (ok) {
+                        raw = tmp;
+                        memcpy(raw + raw_size, pack.data, pack.size);
+                        raw_size += pack.size;
+                }
+        }
+
+        unmap_file(&pack);
+
+        if (ok && !merged) {
+                size_t len = 0;
+                char *image = build_archive(raw, raw_size, hash, &len);
+
+                ok = image != NULL && store_file(dz_path, image, len);
+                free(image);
+                image = NULL;
+        }
+
+        free(raw);
+        raw = NULL;
+
+        if (!ok) {
+                WARNING("Failed to archive history segment.");
+                return false;
+        }
+
+        return unlink(pack_path) == 0;
+}
+
+bool archive_read(Date month, Date key, char **buf, size_t *len)
+{
+        if (buf == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> buf == NULL.");
+                return false;
+        }
+
+        if (len == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> len == NULL.");
+                return false;
+        }
+
+        Archive archive;
+        size_t size = 0;
+        Date to = key == 0 ? UINT32_MAX : key;
+
+        *buf = NULL;
+        *len = 0;
+
+        if (!archive_open(month, &archive))
+                return false;
+
+        for (int pass = 0; pass < 2; pass++) {
+                for (uint32_t i = 0; i < archive.hdr.blocks; i++) {
+                        ArchiveBlock block;
+
+                        archive_block(&archive, i, &block);
+
+                        if (to < block.first || key > block.last)
+                                continue;
+
+                        /* First pass sizes the buffer, second one fills it. */
+                        if (pass == 0) {
+                                size += block.raw_len;
+                                continue;
+                        }
+
+                        if (!archive_unpack(&archive, &block, *buf + *len)) {
+                                FAIL(ERR_FORMAT, "History archive is damaged.");
+                                free(*buf);
+                                *buf = NULL;
+                                *len = 0;
+                                archive_close(&archive);
+                                return false;
+                        }
+
+                        *len += block.raw_len;
+                }
+
+                if (pass == 0 && size > 0 && (*buf = malloc(size)) == NULL) {
+                        FAIL(ERR_NOMEM, "Out of memory.");
+                        archive_close(&archive);
+                        return false;
+                }
+        }
+
+        archive_close(&archive);
+        return true;
+}
+
+bool archive_open(Date month, Archive *archive)
+{
+        if (archive == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> archive == NULL.");
+                return false;
+        }
+
+        char path[SEGMENT_PATHSIZE] = { 0 };
+
+        archive->map.data = NULL;
+        archive->map.size = 0;
+        memset(&archive->hdr, 0, sizeof(ArchiveHdr));
+        segment_path(month, SEGMENT_ARCHIVE, path);
+
+        if (!map_file(path, &archive->map))
+                return errno == ENOENT;
+
+        if (!check_archive(&archive->map)) {
+                FAIL(ERR_FORMAT, "History archive is damaged.");
+                archive_close(archive);
+                return false;
+        }
+
+        memcpy(&archive->hdr, archive->map.data, sizeof(ArchiveHdr));
+        return true;
+}
+
+void archive_block(const Archive *archive, uint32_t index,
+                ArchiveBlock *block)
+{
+        memcpy(block, archive->map.data + sizeof(ArchiveHdr) +
+                        index * sizeof(ArchiveBlock), sizeof(ArchiveBlock));
+}
+
+bool archive_unpack(const Archive *archive, const ArchiveBlock *block,
+                char *dst)
+{
+        return lz_decompress(archive->map.data + block->offset,
+                        block->comp_len, dst, block->raw_len);
+}
+
+void archive_close(Archive *archive)
+{
+        if (archive == NULL)
+                return;
+
+        unmap_file(&archive->map);
+        memset(&archive->hdr, 0, sizeof(ArchiveHdr));
+}
+
+static bool check_archive(const MapFile *map)
+{
+        ArchiveHdr hdr;
+
+        if (map->size < sizeof(ArchiveHdr))
+                return false;
+
+        memcpy(&hdr, map->data, sizeof(ArchiveHdr));
+
+        if (memcmp(hdr.magic, ARCHIVE_MAGIC, sizeof(hdr.magic)) != 0 ||
+                        hdr.version != ARCHIVE_VERSION ||
+                        hdr.blocks > (map->size - sizeof(ArchiveHdr)) /
+                        sizeof(ArchiveBlock))
+                return false;
+
+        const char *table = map->data + sizeof(ArchiveHdr);
+
+        for (uint32_t i = 0; i < hdr.blocks; i++) {
+                ArchiveBlock block;
+
+                memcpy(&block, table + i * sizeof(ArchiveBlock),
+                                sizeof(ArchiveBlock));
+
+                if (block.offset > map->size ||
+                                block.comp_len > map->size - block.offset)
+                        return false;
+        }
+
+        return true;
+}
+
+static char *build_archive(const char *raw, size_t raw_size,
+                uint64_t merged_hash, size_t *len)
+{
+        /* Two neighbour blocks always hold more than ARCHIVE_BLOCK bytes. */
+        size_t max_blocks = 2 * (raw_size / ARCHIVE_BLOCK) + 1;
+        size_t head = sizeof(ArchiveHdr) + max_blocks * sizeof(ArchiveBlock);
+        char *image = malloc(head + raw_size + raw_size / 255 +
+                        16 * max_blocks);
+
+        if (image == NULL) {
+                FAIL(ERR_NOMEM, "Out of memory.");
+                return NULL;
+        }
+
+        ArchiveBlock *table = malloc(max_blocks * sizeof(ArchiveBlock));
+
+        if (table == NULL) {
+                FAIL(ERR_NOMEM, "Out of memory.");
+                free(image);
+                return NULL;
+        }
+
+        uint32_t blocks = 0;
+        size_t data_len = 0;
+        const char *pos = raw;
+        const char *end = raw + raw_size;
+
+        while (pos < end) {
+                const char *start = pos;
+                ArchiveBlock block = { 0, 0, 0, 0, 0 };
+
+                /* Block takes whole lines, at least one of them. */
+                do {
+                        const char *next = pos;
+                        const char *line = NULL;
+                        size_t line_len = 0;
+                        Date key = 0;
+
+                        next_line(&next, end, &line, &line_len);
+
+                        if (pos != start &&
+                                        (size_t) (next - start) > ARCHIVE_BLOCK)
+                                break;
+
+                        pos = next;
+
+                        if (line_len < DATEOFFSET ||
+                                        !date_is_valid(line, &key))
+                                continue;
+
+                        if (block.first == 0 || key < block.first)
+                                block.first = key;
+
+                        if (key > block.last)
+                                block.last = key;
+                } while (pos < end);
+
+                block.raw_len = pos - start;
+                block.offset = data_len;
+                block.comp_len = lz_compress(start, block.raw_len,
+                                image + head + data_len);
+                data_len += block.comp_len;
+                table[blocks++] = block;
+        }
+
+        /* Table is shrunk to the real number of blocks. */
+        size_t table_size = blocks * sizeof(ArchiveBlock);
+
+        memmove(image + sizeof(ArchiveHdr) + table_size, image + head,
+                        data_len);
+        head = sizeof(ArchiveHdr) + table_size;
+
+        for (uint32_t i = 0; i < blocks; i++)
+                table[i].offset += head;
+
+        ArchiveHdr hdr = { { 0 }, ARCHIVE_VERSION, blocks, 0, raw_size,
+                merged_hash };
+
+        memcpy(hdr.magic, ARCHIVE_MAGIC, sizeof(hdr.magic));
+        memcpy(image, &hdr, sizeof(ArchiveHdr));
+        memcpy(image + sizeof(ArchiveHdr), table, table_size);
+        free(table);
+        table = NULL;
+
+        *len = head + data_len;
+        return image;
+}
@@ -0,0 +1,141 @@
+/**
+ * @file archive.h
+ * @brief Interface for block-compressed history archives.
+ *
+ * Segments of closed months are packed into YYYY-MM.dz archives. Archive
+ * starts with ArchiveHdr, followed by the block table and the blocks
+ * compressed with the LZ codec. Every block holds whole lines and the
+ * table keeps the range of dates found in it, so a search decompresses
+ * only the blocks which may hold the searched date.
+ *
+ * Entries saved late for a closed month go to a fresh segment file and
+ * are merged into the archive next time history is opened. Segment is
+ * renamed to YYYY-MM.pack while it's merged; the archive remembers the
+ * hash of the merged file, so an interrupted merge is finished without
+ * merging the same lines twice.
+ *
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "mapfile.h"
+#include "types.h"
+
+/** Magic bytes at the start of the archive file. */
+#define ARCHIVE_MAGIC   "DARC"
+
+/** Version of the archive file layout. */
+#define ARCHIVE_VERSION 1
+
+/** Size of the uncompressed block the archive is split into. */
+#define ARCHIVE_BLOCK   16384
+
+/**
+ * @brief Type definition for the archive file header.
+ */
+typedef struct ArchiveHdr_tag {
+        char     magic[4]; ///< ARCHIVE_MAGIC.
+        uint32_t version; ///< ARCHIVE_VERSION.
+        uint32_t blocks; ///< Number of blocks.
+        uint32_t reserved; ///< Always 0.
+        uint64_t raw_size; ///< Size of all blocks uncompressed.
+        uint64_t merged_hash; ///< Hash of the last merged segment file.
+} ArchiveHdr;
+
+/**
+ * @brief Type definition for the archive block table record.
+ */
+typedef struct ArchiveBlock_tag {
+        Date     first; ///< Earliest date in the block, or 0 if none.
+        Date     last; ///< Latest date in the block, or 0 if none.
+        uint32_t raw_len; ///< Size of the block uncompressed.
+        uint32_t comp_len; ///< Size of the block compressed.
+        uint64_t offset; ///< Offset of the compressed block in the file.
+} ArchiveBlock;
+
+/**
+ * @brief Type definition for the archive open for reading.
+ */
+typedef struct Archive_tag {
+        MapFile    map; ///< Mapping of the archive file.
+        ArchiveHdr hdr; ///< Archive header, no blocks if there is no file.
+} Archive;
+
+/**
+ * @brief Packs segment into the archive.
+ *
+ * Merges the segment file of @p month into its archive and removes the
+ * segment file and its index. Does nothing if there is no segment file.
+ *
+ * @param[in] month Month key of the segment.
+ * @return True on success, or false otherwise.
+ */
+bool archive_segment(Date month);
+
+/**
+ * @brief Reads lines from the archive.
+ *
+ * Decompresses the blocks of the archive of @p month, which may hold
+ * @p key, or all of them if @p key is 0, into one newly allocated buffer
+ * stored into @p buf. Missing archive gives NULL buffer and zero length.
+ * It's responsibility of the caller to free the buffer.
+ *
+ * @param[in] month Month key of the segment.
+ * @param[in] key Date which blocks must hold, or 0 for all blocks.
+ * @param[in,out] buf Pointer, where the buffer is to be stored.
+ * @param[in,out] len Pointer, where the buffer length is to be stored.
+ * @return True on success, or false otherwise.
+ */
+bool archive_read(Date month, Date key, char **buf, size_t *len);
+
+/**
+ * @brief Opens archive for reading blocks.
+ *
+ * Maps the archive of @p month and checks it. Missing archive opens as an
+ * archive without blocks. Archive must be closed with archive_close().
+ * Blocks of an open archive may be unpacked from several threads at once.
+ *
+ * @param[in] month Month key of the segment.
+ * @param[in,out] archive Pointer to the archive, which is to be set.
+ * @return True on success, or false otherwise.
+ */
+bool archive_open(Date month, Archive *archive);
+
+/**
+ * @brief Gets block table record.
+ *
+ * @param[in] archive Pointer to the read-only open archive.
+ * @param[in] index Index of the block, less than the number of blocks.
+ * @param[in,out] block Pointer, where the record is to be stored.
+ * @return Nothing.
+ */
+void archive_block(const Archive *archive, uint32_t index,
+                ArchiveBlock *block);
+
+/**
+ * @brief Decompresses block.
+ *
+ * @param[in] archive Pointer to the read-only open archive.
+ * @param[in] block Pointer to the read-only block table record.
+ * @param[in,out] dst Buffer of at least @p block->raw_len bytes.
+ * @return True on success, or false if the block is damaged.
+ */
+bool archive_unpack(const Archive *archive, const ArchiveBlock *block,
+                char *dst);
+
+/**
+ * @brief Closes archive.
+ *
+ * @param[in,out] archive Pointer to the archive.
+ * @return Nothing.
+ */
+void archive_close(Archive *archive);
+
+#endif
@@ -0,0 +1,164 @@
+/**
+ * @file arena.c
+ * @brief Implementation of the arena allocator.
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#include "arena.h"
+
+/**
+ * @brief Rounds size up to ARENA_ALIGN.
+ */
+#define ALIGN_UP(n) (((n) + ARENA_ALIGN - 1) & ~((size_t) ARENA_ALIGN - 1))
+
+/**
+ * @brief Size of the block header rounded up, so block data stays aligned.
+ */
+#define BLOCK_HDR   ALIGN_UP(sizeof(ArenaBlock))
+
+/**
+ * @brief Adds new block to the arena.
+ * @param[in,out] arena Pointer to the arena.
+ * @param[in] min_size Minimal number of usable bytes in the block.
+ * @return True on success, or false otherwise.
+ */
+static bool add_block(Arena *arena, size_t min_size);
+
+/**
+ * @brief Hands out @p size bytes starting at a multiple of @p align.
+ * @param[in,out] arena Pointer to the arena.
+ * @param[in] size Number of bytes to be allocated.
+ * @param[in] align Alignment, a power of two.
+ * @return Pointer to the memory on success, or NULL otherwise.
+ */
+static void *bump(Arena *arena, size_t size, size_t align);
+
+void arena_init(Arena *arena, size_t block_size)
+{
+        arena->head = NULL;
+        arena->block_size = block_size > 0 ? block_size : 4096;
+}
+
+void *arena_alloc(Arena *arena, size_t size)
+{
+        if (arena == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> arena == NULL.");
+                return NULL;
+        }
+
+        return bump(arena, ALIGN_UP(size), ARENA_ALIGN);
+}
+
+char *arena_strndup(Arena *arena, const char *src, size_t len)
+{
+        if (src == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> src == NULL.");
+                return NULL;
+        }
+
+        char *dest = bump(arena, len + 1, 1);
+
+        if (dest == NULL)
+                return NULL;
+
+        memcpy(dest, src, len);
+        dest[len] = '\0';
+
+        return dest;
+}
+
+bool arena_reserve(Arena *arena, size_t size)
+{
+        if (arena == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> arena == NULL.");
+                return false;
+        }
+
+        size = ALIGN_UP(size);
+        ArenaBlock *block = arena->head;
+
+        if (block != NULL && block->size - block->used >= size)
+                return true;
+
+        return add_block(arena, size);
+}
+
+void arena_reset(Arena *arena)
+{
+        if (arena == NULL || arena->head == NULL)
+                return;
+
+        ArenaBlock *block = arena->head->next;
+
+        while (block != NULL) {
+                ArenaBlock *next = block->next;
+                free(block);
+                block = next;
+        }
+
+        arena->head->next = NULL;
+        arena->head->used = 0;
+}
+
+void arena_destroy(Arena *arena)
+{
+        if (arena == NULL)
+                return;
+
+        ArenaBlock *block = arena->head;
+
+        while (block != NULL) {
+                ArenaBlock *next = block->next;
+                free(block);
+                block = next;
+        }
+
+        arena->head = NULL;
+}
+
+static bool add_block(Arena *arena, size_t min_size)
+{
+        size_t size = arena->block_size;
+
+        while (size < min_size)
+                size *= 2;
+
+        ArenaBlock *block = malloc(BLOCK_HDR + size);
+
+        if (block == NULL) {
+                FAIL(ERR_NOMEM, "Out of memory.");
+                return false;
+        }
+
+        block->next = arena->head;
+        block->size = size;
+        block->used = 0;
+        arena->head = block;
+        arena->block_size = size * 2;
+
+        return true;
+}
+
+static void *bump(Arena *arena, size_t size, size_t align)
+{
+        if (arena == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> arena == NULL.");
+                return NULL;
+        }
+
+        ArenaBlock *block = arena->head;
+        size_t offset = block ? (block->used + align - 1) & ~(align - 1) : 0;
+
+        if (block == NULL || offset > block->size ||
+                        block->size - offset < size) {
+                if (!add_block(arena, size))
+                        return NULL;
+
+                block = arena->head;
+                offset = 0;
+        }
+
+        block->used = offset + size;
+        return (char *) block + BLOCK_HDR + offset;
+}
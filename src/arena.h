@@ -0,0 +1,118 @@
+/**
+ * @file arena.h
+ * @brief Interface for the arena allocator.
+ *
+ * Arena hands out memory from large blocks by bumping a pointer. Single
+ * allocations are never freed; the whole arena is reset or destroyed at
+ * once, so a batch of objects costs a handful of malloc() calls.
+ *
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "error.h"
+
+/** Alignment of every allocation made from the arena. */
+#define ARENA_ALIGN 16
+
+/**
+ * @brief Structure definition for a block of arena memory.
+ *
+ * Block memory follows the header, aligned to ARENA_ALIGN.
+ */
+typedef struct ArenaBlock {
+        struct ArenaBlock *next; ///< Pointer to the previous (smaller) block.
+        size_t            size; ///< Number of usable bytes in the block.
+        size_t            used; ///< Number of bytes handed out.
+} ArenaBlock;
+
+/**
+ * @brief Structure definition for an arena.
+ */
+typedef struct Arena {
+        ArenaBlock *head; ///< Pointer to the current block.
+        size_t     block_size; ///< Size of the next block to be allocated.
+} Arena;
+
+/**
+ * @brief Initializes arena.
+ *
+ * Must be called before the arena specified by @p arena is used. No memory
+ * is allocated until the first request.
+ *
+ * @param[in,out] arena Pointer to the arena to be initialized.
+ * @param[in] block_size Size of the first block in bytes.
+ * @return Nothing.
+ */
+void arena_init(Arena *arena, size_t block_size);
+
+/**
+ * @brief Allocates memory from the arena.
+ *
+ * Returns @p size bytes aligned to ARENA_ALIGN. When the current block is
+ * full, a new one at least twice as big is allocated.
+ *
+ * @param[in,out] arena Pointer to the arena.
+ * @param[in] size Number of bytes to be allocated.
+ * @return Pointer to the memory on success, or NULL otherwise.
+ */
+void *arena_alloc(Arena *arena, size_t size);
+
+/**
+ * @brief Makes an exact-length string copy in the arena.
+ *
+ * Copies @p len bytes of @p src, which needn't be terminated, into the
+ * arena and terminates the copy. Copies are packed without alignment, so
+ * a string takes exactly @p len + 1 bytes.
+ *
+ * @param[in,out] arena Pointer to the arena.
+ * @param[in] src Source bytes.
+ * @param[in] len Number of bytes to be copied.
+ * @return Pointer to the copy on success, or NULL otherwise.
+ */
+char *arena_strndup(Arena *arena, const char *src, size_t len);
+
+/**
+ * @brief Makes sure the arena can serve @p size bytes without growing.
+ *
+ * Allocates one block big enough for @p size bytes, so a bulk load of
+ * known size needs a single malloc(). Allocations made with arena_alloc()
+ * may need up to ARENA_ALIGN - 1 more bytes each.
+ *
+ * @param[in,out] arena Pointer to the arena.
+ * @param[in] size Number of bytes to be reserved.
+ * @return True on success, or false otherwise.
+ */
+bool arena_reserve(Arena *arena, size_t size);
+
+/**
+ * @brief Resets arena.
+ *
+ * Invalidates all memory handed out by the arena. The biggest block is
+ * kept for reuse, all the others are freed.
+ *
+ * @param[in,out] arena Pointer to the arena.
+ * @return Nothing.
+ */
+void arena_reset(Arena *arena);
+
+/**
+ * @brief Destroys arena.
+ *
+ * Frees all the blocks. No other operations are permitted after calling
+ * arena_destroy() unless arena_init() is called again.
+ *
+ * @param[in,out] arena Pointer to the arena.
+ * @return Nothing.
+ */
+void arena_destroy(Arena *arena);
+
+#endif
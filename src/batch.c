@@ -0,0 +1,191 @@
+/**
+ * @file batch.c
+ * @brief Function definitions for non-interactive batch operations.
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#include "batch.h"
+
+/**
+ * @brief Skips spaces.
+ * @param[in] str Read-only string.
+ * @return Pointer to the first character which is not a space.
+ */
+static const char *skip_spaces(const char *str);
+
+/**
+ * @brief Parses task index.
+ * @param[in] str Read-only string starting with the index.
+ * @param[in,out] rest Pointer, where the position after the index is to
+ *                be stored.
+ * @return Index on success, or -1 otherwise.
+ */
+static long parse_index(const char *str, const char **rest);
+
+/**
+ * @brief Checks that nothing but spaces is left.
+ * @param[in] str Read-only string.
+ * @return True if @p str holds only spaces, or false otherwise.
+ */
+static bool at_end(const char *str);
+
+/**
+ * @brief Records that the operation is malformed.
+ * @return False, so the result can be returned by apply_op().
+ */
+static bool malformed(void);
+
+bool apply_op(Tasks *entry, const char *line)
+{
+        if (entry == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> entry == NULL.");
+                return false;
+        }
+
+        if (line == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> line == NULL.");
+                return false;
+        }
+
+        line = skip_spaces(line);
+
+        char op = *line;
+        const char *rest = line + (op != '\0');
+        const char *subject = NULL;
+        long index = -1L;
+
+        if (op == '\0' || op == '#')
+                return true;
+
+        /* Letter must stand alone, so "add milk" isn't "a" of "dd milk". */
+        if (*rest != '\0' && !isspace((unsigned char) *rest))
+                return malformed();
+
+        switch (op) {
+                case 'a':
+                        subject = skip_spaces(rest);
+                        return *subject != '\0' &&
+                                add_task(entry, subject, UNDONE);
+
+                case 'c':
+                        index = parse_index(rest, &rest);
+                        subject = skip_spaces(rest);
+                        return *subject != '\0' &&
+                                change_task(entry, index, subject);
+
+                case 'd':
+                        index = parse_index(rest, &rest);
+                        return at_end(rest) ? delete_task(entry, index) :
+                                malformed();
+
+                case 'u':
+                        index = parse_index(rest, &rest);
+                        return at_end(rest) ? undo_task(entry, index) :
+                                malformed();
+
+                case 'x':
+                        index = parse_index(rest, &rest);
+                        return at_end(rest) ? do_task(entry, index) :
+                                malformed();
+
+                case 'D':
+                        if (!at_end(rest))
+                                return malformed();
+                        reset_tasks(entry);
+                        return true;
+
+                case 'U':
+                        if (!at_end(rest))
+                                return malformed();
+                        set_all_tasks(entry, UNDONE);
+                        return true;
+
+                case 'X':
+                        if (!at_end(rest))
+                                return malformed();
+                        set_all_tasks(entry, DONE);
+                        return true;
+
+                default:
+                        return malformed();
+        }
+}
+
+bool run_batch(Tasks *entry, FILE *fp)
+{
+        if (entry == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> entry == NULL.");
+                return false;
+        }
+
+        if (fp == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> fp == NULL.");
+                return false;
+        }
+
+        char *line = NULL;
+        size_t size = 0;
+        ssize_t len = 0;
+        long line_no = 0;
+        ErrCode failed = ERR_NONE;
+
+        while ((len = getline(&line, &size, fp)) != -1) {
+                ++line_no;
+
+                if (len > 0 && line[len - 1] == '\n')
+                        line[len - 1] = '\0';
+
+                err_clear();
+
+                if (apply_op(entry, line))
+                        continue;
+
+                /* Operations which fail without a reason are malformed. */
+                failed = err_last()->code != ERR_NONE ? err_last()->code :
+                        ERR_FORMAT;
+                fprintf(stderr, "doit: line %ld: %s: %s\n", line_no,
+                                err_name(failed), line);
+        }
+
+        free(line);
+        line = NULL;
+
+        /* Reason of the last failure is left for the caller. */
+        if (failed != ERR_NONE)
+                err_set(failed, "Batch operation failed.");
+
+        return failed == ERR_NONE;
+}
+
+static const char *skip_spaces(const char *str)
+{
+        while (isspace((unsigned char) *str))
+                ++str;
+
+        return str;
+}
+
+static long parse_index(const char *str, const char **rest)
+{
+        char *end = NULL;
+        long index = strtol(str, &end, 10);
+
+        *rest = end;
+
+        if (end == str || (*end != '\0' && !isspace((unsigned char) *end)))
+                return -1L;
+
+        return index;
+}
+
+static bool at_end(const char *str)
+{
+        return *skip_spaces(str) == '\0';
+}
+
+static bool malformed(void)
+{
+        err_set(ERR_FORMAT, "Bad operation.");
+        return false;
+}
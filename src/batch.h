@@ -0,0 +1,64 @@
+/**
+ * @file batch.h
+ * @brief Interface for non-interactive batch operations.
+ *
+ * Batch operations are lines of text, one operation per line, using the
+ * same letters as the interactive options:
+ *
+ *      a <subject>             add task
+ *      c <index> <subject>     change task
+ *      d <index>               delete task
+ *      D                       delete all tasks
+ *      u <index>               undo task
+ *      U                       undo all tasks
+ *      x <index>               do task
+ *      X                       do all tasks
+ *
+ * Empty lines and lines starting with '#' are ignored.
+ *
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "error.h"
+#include "tasks.h"
+#include "types.h"
+
+/**
+ * @brief Applies single operation.
+ *
+ * Parses the operation specified by @p line and applies it to the task
+ * list specified by @p entry, without redrawing the screen or asking
+ * anything. @p line may end with a newline.
+ *
+ * @param[in,out] entry Pointer to the task list.
+ * @param[in] line Read-only string with the operation.
+ * @return True on success, or false if the operation is malformed or
+ *         can't be applied.
+ */
+bool apply_op(Tasks *entry, const char *line);
+
+/**
+ * @brief Applies all the operations from the stream.
+ *
+ * Reads operations from @p fp line by line and applies them to the task
+ * list specified by @p entry. Operations that fail are reported to
+ * stderr with their line number and the error name and skipped. The error
+ * code of the last failure is kept, see err_last().
+ *
+ * @param[in,out] entry Pointer to the task list.
+ * @param[in] fp File pointer to the stream with operations.
+ * @return True if every operation succeeded, or false otherwise.
+ */
+bool run_batch(Tasks *entry, FILE *fp);
+
+#endif
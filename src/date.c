@@ -7,132 +7,199 @@
 
 #include "date.h"
 
-bool get_curr_date(char *date)
+/**
+ * @brief Cached current date.
+ *
+ * Current day is computed once and reused until time() leaves the
+ * [day_start, next_day) interval, i.e. until midnight or until the
+ * system clock is set back.
+ */
+static struct {
+        pthread_mutex_t lock; ///< Serializes access to the cache.
+        Date   date; ///< Cached current date, or 0 if not computed yet.
+        time_t day_start; ///< Timestamp of the last midnight.
+        time_t next_day; ///< Timestamp of the next midnight.
+} curr_day = { PTHREAD_MUTEX_INITIALIZER, 0, 0, 0 };
+
+/**
+ * @brief Recomputes cached current date.
+ * @param[in] now Current timestamp.
+ * @return True on success, or false otherwise.
+ */
+static bool refresh_curr_day(time_t now);
+
+/**
+ * @brief Converts date into the number of days since 01.01.1970.
+ * @param[in] date Date, which is to be converted.
+ * @return Number of days.
+ */
+static long date_to_days(Date date);
+
+/**
+ * @brief Converts number of days since 01.01.1970 into a date.
+ * @param[in] days Number of days.
+ * @return Date.
+ */
+static Date days_to_date(long days);
+
+bool get_curr_date(Date *date)
 {
         if (date == NULL) {
-                WARNING("Bad parameter -> date == NULL.");
+                FAIL(ERR_PARAM, "Bad parameter -> date == NULL.");
                 return false;
         }
 
         time_t now = time(NULL);
-        struct tm *t = localtime(&now);
-        strftime(date, DATESIZE, "%d.%m.%Y", t);
+        bool ok = true;
 
-        return true;
+        pthread_mutex_lock(&curr_day.lock);
+
+        if (curr_day.date == 0 || now < curr_day.day_start ||
+                        now >= curr_day.next_day)
+                ok = refresh_curr_day(now);
+
+        *date = curr_day.date;
+
+        pthread_mutex_unlock(&curr_day.lock);
+        return ok;
 }
 
-bool get_last_entry_date(FILE *fp, char *date)
+bool date_is_valid(const char *str, Date *date)
 {
-        if (fp == NULL) {
-                WARNING("Bad parameter -> fp == NULL.");
+        if (str == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> str == NULL.");
                 return false;
         }
 
-        if (date == NULL) {
-                WARNING("Bad parameter -> date == NULL.");
-                return false;
-        }
+        static const char layout[DATESIZE] = "dd.mm.yyyy";
 
-        char line[LINESIZE] = { 0 };
+        unsigned field[3] = { 0, 0, 0 };
+        unsigned bad = 0;
+        int f = 0;
 
-        if (fgets(line, DATESIZE, fp) == NULL) {
-                WARNING("Failed to read line form a file.");
-                rewind(fp);
-                return false;
-        }
+        for (int i = 0; i < DATEOFFSET; i++) {
+                unsigned char c = str[i];
 
-        strncpy(date, line, DATEOFFSET);
-        date[DATESIZE - 1] = '\0';
+                if (c == '\0')
+                        return false;
 
-        if (!date_is_valid(date)) {
-                WARNING("Date is not valid.");
-                rewind(fp);
-                return false;
+                if (layout[i] == '.') {
+                        bad |= c != '.';
+                        ++f;
+                        continue;
+                }
+
+                unsigned digit = c - '0';
+                bad |= digit > 9;
+                field[f] = field[f] * 10 + digit;
         }
 
-        rewind(fp);
-        return true;
+        return !bad && date_make(field[0], field[1], field[2], date);
 }
 
-bool date_is_valid(char *date)
+bool date_make(unsigned day, unsigned month, unsigned year, Date *date)
 {
-        if (date == NULL) {
-                WARNING("Bad parameter -> date == NULL.");
-                return false;
-        }
-
-        char *tmp = malloc(DATESIZE);
+        static const unsigned char mdays[13] = {
+                0, 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31
+        };
 
-        if (tmp == NULL) {
-                WARNING("Out of memory.");
+        /* Unsigned wrap turns zero day and month into out of range values. */
+        if ((month - 1) > 11 || year < DATE_MIN_YEAR || year > DATE_MAX_YEAR)
                 return false;
-        }
 
-        strncpy(tmp, date, DATESIZE);
+        unsigned leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+        unsigned last = mdays[month] - (month == 2 && !leap);
 
-        char *delim = ".";
-        char *d = strtok(tmp, delim);
-
-        if (d == NULL)
-                goto fail;
-
-        char *m = strtok(NULL, delim);
+        if ((day - 1) >= last)
+                return false;
 
-        if (m == NULL)
-                goto fail;
+        if (date != NULL)
+                *date = DATE_PACK(day, month, year);
 
-        char *y = strtok(NULL, delim);
+        return true;
+}
 
-        if (y == NULL)
-                goto fail;
+void date_to_str(Date date, char *str)
+{
+        if (str == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> str == NULL.");
+                return;
+        }
 
-        long day = strtol(d, NULL, 10);
-        long month = strtol(m, NULL, 10);
-        long year = strtol(y, NULL, 10);
+        snprintf(str, DATESIZE, "%02u.%02u.%04u", (unsigned) DATE_DAY(date),
+                        (unsigned) DATE_MONTH(date),
+                        (unsigned) DATE_YEAR(date) % 10000);
+}
 
-        if ((day < 1) || (day > 31))
-                goto fail;
+Date date_week_key(Date date)
+{
+        long days = date_to_days(date);
 
-        if ((month < 1) || (month > 12))
-                goto fail;
+        /* 01.01.1970 was Thursday, which is day 3 of a week from Monday. */
+        return days_to_date(days - (days + 3) % 7);
+}
 
-        if (year < 2016 || year > 2060)
-                goto fail;
+bool is_outdated(Date date)
+{
+        Date curr_date = 0;
 
-        free(tmp);
-        tmp = NULL;
-        return true;
+        if (!get_curr_date(&curr_date)) {
+                WARNING("Failed to get current date.");
+                return false;
+        }
 
-fail:
-        free(tmp);
-        tmp = NULL;
-        return false;
+        return date != curr_date;
 }
 
-bool is_outdated(char *date)
+static bool refresh_curr_day(time_t now)
 {
-        if (date == NULL) {
-                WARNING("Bad parameter -> date == NULL.");
+        struct tm t;
+
+        if (localtime_r(&now, &t) == NULL)
                 return false;
-        }
 
-        char curr_date[DATESIZE] = { 0 };
+        curr_day.date = DATE_PACK(t.tm_mday, t.tm_mon + 1, t.tm_year + 1900);
 
-        if (!get_curr_date(curr_date)) {
-                WARNING("Failed to get current date.");
-                return false;
-        }
+        t.tm_hour = 0;
+        t.tm_min = 0;
+        t.tm_sec = 0;
+        t.tm_isdst = -1;
+        curr_day.day_start = mktime(&t);
 
-        return !STRCMP(date, ==, curr_date);
+        /* mktime() normalizes day overflow into the next month or year. */
+        t.tm_mday += 1;
+        t.tm_isdst = -1;
+        curr_day.next_day = mktime(&t);
+
+        return true;
 }
 
-void show_curr_date(void)
+static long date_to_days(Date date)
 {
-        char date[DATESIZE] = { 0 };
-        if (!get_curr_date(date)) {
-                WARNING("Failed to get current date.");
-                return;
-        }
+        /* Years are counted from March, so February is the last month. */
+        long year = (long) DATE_YEAR(date) - (DATE_MONTH(date) <= 2);
+        long month = DATE_MONTH(date);
+        long era = year / 400;
+        long yoe = year - era * 400;
+        long doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 +
+                (long) DATE_DAY(date) - 1;
+        long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+        return era * 146097 + doe - 719468;
+}
 
-        printf("%s\n", date);
+static Date days_to_date(long days)
+{
+        days += 719468;
+
+        long era = days / 146097;
+        long doe = days - era * 146097;
+        long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        long mp = (5 * doy + 2) / 153;
+        long day = doy - (153 * mp + 2) / 5 + 1;
+        long month = mp < 10 ? mp + 3 : mp - 9;
+        long year = yoe + era * 400 + (month <= 2);
+
+        return DATE_PACK(day, month, year);
 }
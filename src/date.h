@@ -8,7 +8,9 @@
 #ifndef DATE_H
 #define DATE_H
 
+#include <pthread.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -18,69 +20,87 @@
 #include "error.h"
 #include "types.h"
 
+/** Earliest year accepted by date_is_valid(). */
+#define DATE_MIN_YEAR 2016
+
+/** Latest year accepted by date_is_valid(). */
+#define DATE_MAX_YEAR 2060
+
 /**
  * @brief Gets current system time.
  *
  * @p date must not be NULL. It's responsibility of the caller to manage
- * the storage for the date string. Size of the date string must be equal to
- * DATESIZE, which is defined in types.h. 
+ * the storage for the date. The date is computed once and cached; it's
+ * recomputed only when the wall clock crosses midnight. Safe to call from
+ * several threads.
  *
- * @param[in,out] date String, where date is going to be stored.
+ * @param[in,out] date Pointer, where date is going to be stored.
  * @return True on success or false otherwise.
  */
-bool get_curr_date(char *date);
+bool get_curr_date(Date *date);
 
 /**
- * @brief Gets last entry date from file.
+ * @brief Checks if date is valid and converts it into a Date.
  *
- * Reads last entry date from last_entry.txt. Both parameters must
- * not be NULL. It's the responsibility of the caller to manage the
- * storage associated with the @p date and provide valid pointer to file.
- * Size of date string must be equal to DATESIZE, which is defined in types.h.
- * Uses function date_is_valid() to check if obtained date is valid.
+ * Parses first DATEOFFSET characters of @p str in dd.mm.yyyy form in
+ * a single pass, without allocating memory, and checks day against the
+ * length of the month, leap years included. @p str must not be NULL and
+ * doesn't have to be terminated right after the date. If @p date is not
+ * NULL, the parsed date is stored there on success.
  *
- * @param[in] fp Pointer to last_entry.txt file from where the date will be
- *            taken.
- * @param[in,out] date String, where entry date will be stored.
+ * @param[in] str String starting with the date to be checked.
+ * @param[in,out] date Pointer, where the date is to be stored, or NULL.
  * @return True on success or false otherwise.
  */
-bool get_last_entry_date(FILE *fp, char *date);
+bool date_is_valid(const char *str, Date *date);
 
 /**
- * @brief Checks if date is valid.
+ * @brief Checks date fields and packs them into a Date.
  *
- * Takes string with the date and checks if it's valid for a further usage.
- * @p date must not be NULL. It's responsibility of the caller to manage the
- * storage associated with it. Size of the date string must be equal to
- * DATESIZE, which is defined in types.h.
+ * Checks year against DATE_MIN_YEAR and DATE_MAX_YEAR and day against the
+ * length of the month, leap years included. If @p date is not NULL, the
+ * packed date is stored there on success.
  *
- * @param[in] date String containing the date to be checked.
- * @return True on success or false otherwise.
+ * @param[in] day Day of the month.
+ * @param[in] month Month from 1 to 12.
+ * @param[in] year Year.
+ * @param[in,out] date Pointer, where the date is to be stored, or NULL.
+ * @return True if the fields make a valid date, or false otherwise.
  */
-bool date_is_valid(char *date);
+bool date_make(unsigned day, unsigned month, unsigned year, Date *date);
 
 /**
- * @brief Checks if date is current.
+ * @brief Converts Date into a string.
  *
- * Takes string with the date and checks if it equals to the current system
- * date. @p date must not be NULL. It's the responsibility of the caller to
- * manage the storage associated with the date string. Size of the date string
- * must be equal to DATESIZE, which is defined in types.h. Uses
- * get_current_date() to obtain current system time.
+ * Formats @p date as dd.mm.yyyy into @p str. Size of the string must be
+ * equal to DATESIZE, which is defined in types.h.
  *
- * @param[in] String containing the date.
- * @return True if date is outdated or false otherwise.
+ * @param[in] date Date, which is to be formatted.
+ * @param[in,out] str String, where the date is to be stored.
+ * @return Nothing.
  */
-bool is_outdated(char *date);
+void date_to_str(Date date, char *str);
 
 /**
- * @brief Shows current date.
+ * @brief Gets week key of a date.
  *
- * Gets current date by calling get_current_date() and printing it.
+ * Weeks start on Monday, so the key is the date of the Monday of the week
+ * @p date belongs to. The Monday may fall into the previous month or year.
  *
- * @param None.
- * @return Nothing.
+ * @param[in] date Date, which week is to be found.
+ * @return Date of the Monday of the week.
+ */
+Date date_week_key(Date date);
+
+/**
+ * @brief Checks if date is current.
+ *
+ * Takes the date and checks if it equals to the current system date.
+ * Uses get_curr_date() to obtain current system time.
+ *
+ * @param[in] date Date, which is to be checked.
+ * @return True if date is outdated or false otherwise.
  */
-void show_curr_date(void);
+bool is_outdated(Date date);
 
 #endif
@@ -0,0 +1,198 @@
+/**
+ * @file error.c
+ * @brief Function definitions for error reporting.
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "error.h"
+
+/**
+ * @brief Copies message into the record, cutting it if it's too long.
+ */
+static void set_msg(ErrRecord *rec, const char *msg);
+
+/** Last error of the thread. */
+static ERR_THREAD_LOCAL ErrRecord last_error;
+
+/** Guards sinks, the ring and the report counter. */
+static pthread_mutex_t sink_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/** Sinks in use. */
+static int sink_mask = ERR_SINK_STDERR;
+
+/** Descriptor of the log file, or -1 if it's not open. */
+static int log_fd = -1;
+
+/** Latest reports, report number seq is kept at seq % ERR_RING_SIZE. */
+static ErrRecord ring[ERR_RING_SIZE];
+
+/** Number of the latest report. */
+static uint64_t last_seq = 0;
+
+void err_report(ErrLevel level, ErrCode code, const char *file, int line,
+                const char *func, const char *msg)
+{
+        int saved_errno = errno;
+        ErrRecord rec;
+
+        memset(&rec, 0, sizeof(ErrRecord));
+        rec.level = level;
+        rec.code = code == ERR_IO && errno == ENOMEM ? ERR_NOMEM : code;
+        rec.errnum = rec.code == ERR_IO || rec.code == ERR_NOMEM ? errno : 0;
+        rec.file = file;
+        rec.func = func;
+        rec.line = line;
+        set_msg(&rec, msg);
+
+        pthread_mutex_lock(&sink_lock);
+        rec.seq = ++last_seq;
+
+        if (sink_mask & ERR_SINK_RING)
+                ring[rec.seq % ERR_RING_SIZE] = rec;
+
+        if (sink_mask & (ERR_SINK_STDERR | ERR_SINK_FILE)) {
+                char text[ERR_MSGSIZE + 256];
+                int len = err_format(&rec, text, sizeof(text));
+
+                if (len < 0)
+                        len = 0;
+                else if ((size_t) len >= sizeof(text))
+                        len = sizeof(text) - 1;
+
+                if (sink_mask & ERR_SINK_STDERR)
+                        fprintf(stderr, "\n%s", text);
+
+                /* One write per report keeps lines of threads apart. */
+                if ((sink_mask & ERR_SINK_FILE) && log_fd >= 0 &&
+                                write(log_fd, text, len) < 0)
+                        sink_mask &= ~ERR_SINK_FILE;
+        }
+
+        pthread_mutex_unlock(&sink_lock);
+
+        if (rec.code != ERR_NONE && (rec.code != ERR_FAILED ||
+                                last_error.code == ERR_NONE))
+                last_error = rec;
+
+        errno = saved_errno;
+}
+
+void err_set(ErrCode code, const char *msg)
+{
+        last_error.seq = 0;
+        last_error.level = ERR_LEVEL_WARNING;
+        last_error.code = code;
+        last_error.errnum = code == ERR_IO || code == ERR_NOMEM ? errno : 0;
+        last_error.file = NULL;
+        last_error.func = NULL;
+        last_error.line = 0;
+        set_msg(&last_error, msg);
+}
+
+const ErrRecord *err_last(void)
+{
+        return &last_error;
+}
+
+void err_clear(void)
+{
+        memset(&last_error, 0, sizeof(ErrRecord));
+}
+
+const char *err_name(ErrCode code)
+{
+        switch (code) {
+                case ERR_NONE:
+                        return "no error";
+                case ERR_FAILED:
+                        return "failed";
+                case ERR_PARAM:
+                        return "bad parameter";
+                case ERR_NOMEM:
+                        return "out of memory";
+                case ERR_IO:
+                        return "i/o error";
+                case ERR_FORMAT:
+                        return "bad format";
+        }
+
+        return "unknown error";
+}
+
+bool err_sink(int sinks, const char *path)
+{
+        int fd = -1;
+
+        if ((sinks & ERR_SINK_FILE) && (path == NULL || (fd = open(path,
+                                                O_WRONLY | O_APPEND | O_CREAT,
+                                                0644)) < 0))
+                return false;
+
+        pthread_mutex_lock(&sink_lock);
+
+        if (log_fd >= 0)
+                close(log_fd);
+
+        log_fd = fd;
+        sink_mask = sinks;
+        pthread_mutex_unlock(&sink_lock);
+        return true;
+}
+
+bool err_ring_next(uint64_t *seq, ErrRecord *rec)
+{
+        if (seq == NULL || rec == NULL)
+                return false;
+
+        bool found = false;
+
+        pthread_mutex_lock(&sink_lock);
+
+        uint64_t oldest = last_seq >= ERR_RING_SIZE ?
+                last_seq - ERR_RING_SIZE + 1 : 1;
+        uint64_t next = *seq + 1 > oldest ? *seq + 1 : oldest;
+
+        /* Slots of reports made while the ring was off hold older ones. */
+        for (; next <= last_seq && !found; next++) {
+                const ErrRecord *slot = &ring[next % ERR_RING_SIZE];
+
+                if (slot->seq == next) {
+                        *rec = *slot;
+                        found = true;
+                }
+        }
+
+        *seq = found ? rec->seq : last_seq;
+        pthread_mutex_unlock(&sink_lock);
+        return found;
+}
+
+int err_format(const ErrRecord *rec, char *buf, size_t size)
+{
+        static const char *levels[] = { "INFO", "WARNING", "ERROR" };
+
+        if (rec->level == ERR_LEVEL_INFO)
+                return snprintf(buf, size, "[INFO] %s\n(%s:%d:%s())\n",
+                                rec->msg, rec->file, rec->line, rec->func);
+
+        return snprintf(buf, size, "[%s] %s\n(%s:%d:%s(): %s)\n",
+                        levels[rec->level], rec->msg, rec->file, rec->line,
+                        rec->func, rec->errnum == 0 ? "no errno" :
+                        strerror(rec->errnum));
+}
+
+static void set_msg(ErrRecord *rec, const char *msg)
+{
+        size_t len = msg ? strlen(msg) : 0;
+
+        if (len > ERR_MSGSIZE - 1)
+                len = ERR_MSGSIZE - 1;
+
+        memcpy(rec->msg, msg ? msg : "", len);
+        rec->msg[len] = '\0';
+}
@@ -1,6 +1,14 @@
 /**
  * @file error.h
  * @brief Macros for handling errors, warnings and info messaged.
+ *
+ * Reporting never blocks. Every report is stored as the last error of the
+ * calling thread, so a function which has failed returns false or -1 and
+ * its caller may still learn the reason with err_last(), like with errno.
+ * Reports are also sent to the configured sinks: stderr, a log file and
+ * an in-memory ring. Waiting for the user to read a message is up to the
+ * interface, which takes the messages from the ring, see show_reports().
+ *
  * @author Vitaliy Pisnya
  * @date July, 2016
  */
@@ -8,17 +16,168 @@
 #ifndef ERROR_H
 #define ERROR_H
 
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <errno.h>
 #include <string.h>
 
+/** Maximum length of the stored message, including '\0'. */
+#define ERR_MSGSIZE  128
+
+/** Number of the latest reports kept in the ring. */
+#define ERR_RING_SIZE 64
+
+/** Environment variable with the name of the log file. */
+#define ERR_LOG_ENV  "DOIT_LOG"
+
+/**
+ * Storage class of the last error, one per thread. C99 has none, so older
+ * standards rely on __thread, a GNU extension gcc and clang accept even
+ * with -std=c99 -Wpedantic.
+ */
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define ERR_THREAD_LOCAL _Thread_local
+#else
+#define ERR_THREAD_LOCAL __thread
+#endif
+
+/**
+ * @brief Type definition for error codes.
+ */
+typedef enum ErrCode_tag {
+        ERR_NONE, ///< No error.
+        ERR_FAILED, ///< Failure without a more specific reason.
+        ERR_PARAM, ///< Bad parameter.
+        ERR_NOMEM, ///< Out of memory.
+        ERR_IO, ///< System call has failed, see the stored errno.
+        ERR_FORMAT ///< Damaged file or invalid input.
+} ErrCode;
+
+/**
+ * @brief Type definition for report levels.
+ */
+typedef enum ErrLevel_tag {
+        ERR_LEVEL_INFO, ///< Informative message.
+        ERR_LEVEL_WARNING, ///< Operation has failed, the program goes on.
+        ERR_LEVEL_ERROR ///< Operation has failed, the program stops.
+} ErrLevel;
+
+/**
+ * @brief Type definition for sinks, which may be combined.
+ */
+typedef enum ErrSink_tag {
+        ERR_SINK_STDERR = 1, ///< Reports are printed to stderr.
+        ERR_SINK_FILE = 2, ///< Reports are appended to the log file.
+        ERR_SINK_RING = 4 ///< Reports are kept in the ring.
+} ErrSink;
+
+/**
+ * @brief Type definition for the report.
+ */
+typedef struct ErrRecord_tag {
+        uint64_t   seq; ///< Number of the report, starting with 1.
+        ErrLevel   level; ///< Report level.
+        ErrCode    code; ///< Error code.
+        int        errnum; ///< Value of errno for ERR_IO and ERR_NOMEM, or 0.
+        const char *file; ///< Source file the report comes from.
+        const char *func; ///< Function the report comes from.
+        int        line; ///< Source line the report comes from.
+        char       msg[ERR_MSGSIZE]; ///< Message.
+} ErrRecord;
+
+/**
+ * @brief Stores and sends report.
+ *
+ * Makes the report the last error of the calling thread and sends it to
+ * the configured sinks. Reports with ERR_NONE code are only sent, and ones
+ * with ERR_FAILED don't replace the last error, which is closer to the
+ * reason. Keeps errno. May be called from any thread.
+ *
+ * @param[in] level Report level.
+ * @param[in] code Error code, ERR_IO becomes ERR_NOMEM if errno is ENOMEM.
+ * @param[in] file Source file name.
+ * @param[in] line Source line number.
+ * @param[in] func Function name.
+ * @param[in] msg Message.
+ * @return Nothing.
+ */
+void err_report(ErrLevel level, ErrCode code, const char *file, int line,
+                const char *func, const char *msg);
+
+/**
+ * @brief Stores error without sending it anywhere.
+ *
+ * Used by cheap checks, whose callers decide whether the failure is worth
+ * a report.
+ *
+ * @param[in] code Error code.
+ * @param[in] msg Message.
+ * @return Nothing.
+ */
+void err_set(ErrCode code, const char *msg);
+
+/**
+ * @brief Gets the last error of the calling thread.
+ * @return Pointer to the read-only record, with ERR_NONE code if none.
+ */
+const ErrRecord *err_last(void);
+
+/**
+ * @brief Forgets the last error of the calling thread.
+ * @return Nothing.
+ */
+void err_clear(void);
+
+/**
+ * @brief Gets name of the error code.
+ * @param[in] code Error code.
+ * @return Read-only string with the name.
+ */
+const char *err_name(ErrCode code);
+
+/**
+ * @brief Sets sinks.
+ *
+ * Reports go to the sinks specified by @p sinks from now on. The log file
+ * specified by @p path is opened for appending, if ERR_SINK_FILE is set.
+ *
+ * @param[in] sinks Combination of ErrSink values, or 0 for none.
+ * @param[in] path Name of the log file, may be NULL without ERR_SINK_FILE.
+ * @return True on success, or false if the log file can't be opened.
+ */
+bool err_sink(int sinks, const char *path);
+
+/**
+ * @brief Takes next report from the ring.
+ *
+ * Copies the oldest report kept in the ring with a number greater than
+ * @p seq into @p rec and moves @p seq to it. Reports pushed out of the
+ * ring before they were taken are skipped.
+ *
+ * @param[in,out] seq Pointer to the number of the last taken report.
+ * @param[in,out] rec Pointer, where the report is to be copied.
+ * @return True if a report was taken, or false if there is none.
+ */
+bool err_ring_next(uint64_t *seq, ErrRecord *rec);
+
+/**
+ * @brief Formats report as text.
+ *
+ * @param[in] rec Pointer to the read-only report.
+ * @param[in,out] buf Buffer, where the text is to be stored.
+ * @param[in] size Size of the buffer.
+ * @return Length of the text, as for snprintf().
+ */
+int  err_format(const ErrRecord *rec, char *buf, size_t size);
+
 /**
  * @brief Macro that provides errno output in a more convenient form.
  */
 #define CLEAN_ERRNO() (errno == 0 ? "no errno" : strerror(errno))
 
 /**
- * @brief Macro that shows detailed information about current error.
+ * @brief Macro that reports error with detailed information.
  *
  * Provided information contains:
  *      - error description
@@ -30,32 +189,30 @@
  * @param[in] M Message describing the cause of an error.
  */
 #define ERROR(M) \
-{ \
-        fprintf(stderr, "\n[ERROR] %s\n(%s:%d:%s(): %s)\n", \
-                        M, __FILE__, __LINE__, __func__, CLEAN_ERRNO()); \
-        printf("\nPress <Enter> to exit the program..."); \
-        while (getchar() != '\n') continue; \
-}
+        err_report(ERR_LEVEL_ERROR, ERR_FAILED, __FILE__, __LINE__, \
+                        __func__, M)
 
 /**
- * @brief Macro that shows warning with detailed information.
+ * @brief Macro that reports warning with detailed information.
  *
- * Provided information contains:
- *      - warning description
- *      - file name
- *      - line number
- *      - function name
- *      - errno message
+ * Provided information is the same as for ERROR(). Error code is
+ * ERR_FAILED, use FAIL() to give a more specific one, e.g. ERR_IO after
+ * a failed system call.
  *
  * @param[in] M Warning message.
  */
 #define WARNING(M) \
-{ \
-        fprintf(stderr, "\n[WARNING] %s\n(%s:%d:%s(): %s)\n", \
-                        M, __FILE__, __LINE__, __func__, CLEAN_ERRNO()); \
-        printf("\nPress <Enter> to continue..."); \
-        while (getchar() != '\n') continue; \
-}
+        err_report(ERR_LEVEL_WARNING, ERR_FAILED, __FILE__, __LINE__, \
+                        __func__, M)
+
+/**
+ * @brief Macro that reports warning with the error code specified by @p C.
+ *
+ * @param[in] C Error code.
+ * @param[in] M Warning message.
+ */
+#define FAIL(C, M) \
+        err_report(ERR_LEVEL_WARNING, C, __FILE__, __LINE__, __func__, M)
 
 /**
  * @brief Macro that provides user with useful information.
@@ -69,12 +226,7 @@
  * @param[in] M Informative message.
  */
 #define INFO(M) \
-{ \
-        fprintf(stderr, "\n[INFO] %s\n(%s:%d:%s())\n", M, __FILE__, __LINE__, \
-                        __func__); \
-        printf("\nPress <Enter> to continue..."); \
-        while (getchar() != '\n') continue; \
-}
+        err_report(ERR_LEVEL_INFO, ERR_NONE, __FILE__, __LINE__, __func__, M)
 
 /**
  * @brief Macro that checks if expression for validity.
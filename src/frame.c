@@ -0,0 +1,241 @@
+/**
+ * @file frame.c
+ * @brief Function definitions for buffered screen rendering.
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#include "frame.h"
+
+/**
+ * @brief Type definition for a growable text buffer.
+ */
+typedef struct FrameBuf_tag {
+        char   *data; ///< Buffer memory.
+        size_t len; ///< Number of bytes used.
+        size_t cap; ///< Number of bytes allocated.
+} FrameBuf;
+
+/** Frame being rendered. */
+static FrameBuf curr;
+
+/** Last screen frame sent to the terminal. */
+static FrameBuf prev;
+
+/** True if prev describes what's on the screen. */
+static bool prev_valid;
+
+/** Kind of the frame being rendered. */
+static FrameMode curr_mode = FRAME_SCREEN;
+
+/**
+ * @brief Makes sure buffer can take @p extra more bytes.
+ * @param[in,out] buf Pointer to the buffer.
+ * @param[in] extra Number of bytes to be appended.
+ * @return True on success, or false otherwise.
+ */
+static bool buf_reserve(FrameBuf *buf, size_t extra);
+
+/**
+ * @brief Writes all the bytes to standard output.
+ * @param[in] data Bytes to be written.
+ * @param[in] len Number of bytes.
+ * @return True on success, or false otherwise.
+ */
+static bool write_all(const char *data, size_t len);
+
+/**
+ * @brief Gets number of terminal rows.
+ * @return Number of rows, or 0 if stdout is not a terminal.
+ */
+static int term_rows(void);
+
+void frame_begin(FrameMode mode)
+{
+        /* Anything printed with stdio so far must reach the screen first. */
+        fflush(stdout);
+
+        curr.len = 0;
+        curr_mode = mode;
+
+        if (mode == FRAME_STREAM) {
+                prev_valid = false;
+                frame_write(FRAME_CLEAR, strlen(FRAME_CLEAR));
+        }
+}
+
+void frame_printf(const char *fmt, ...)
+{
+        if (fmt == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> fmt == NULL.");
+                return;
+        }
+
+        va_list ap;
+
+        va_start(ap, fmt);
+        int len = vsnprintf(NULL, 0, fmt, ap);
+        va_end(ap);
+
+        if (len < 0 || !buf_reserve(&curr, len + 1))
+                return;
+
+        va_start(ap, fmt);
+        vsnprintf(curr.data + curr.len, len + 1, fmt, ap);
+        va_end(ap);
+
+        curr.len += len;
+
+        if (curr_mode == FRAME_STREAM && curr.len >= FRAME_CHUNK)
+                frame_flush();
+}
+
+void frame_write(const char *str, size_t len)
+{
+        if (str == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> str == NULL.");
+                return;
+        }
+
+        if (!buf_reserve(&curr, len))
+                return;
+
+        memcpy(curr.data + curr.len, str, len);
+        curr.len += len;
+
+        if (curr_mode == FRAME_STREAM && curr.len >= FRAME_CHUNK)
+                frame_flush();
+}
+
+bool frame_flush(void)
+{
+        fflush(stdout);
+
+        if (curr_mode == FRAME_STREAM) {
+                bool ok = write_all(curr.data, curr.len);
+                curr.len = 0;
+                return ok;
+        }
+
+        /* Line, from which the screen is to be redrawn. */
+        size_t from = 0;
+        int row = 0;
+        int rows = term_rows();
+
+        if (prev_valid && rows > 0) {
+                size_t last = 0;
+                int lines = 0;
+
+                for (size_t i = 0; i < curr.len; i++) {
+                        if (curr.data[i] == '\n') {
+                                last = i + 1;
+                                ++lines;
+                        }
+                }
+
+                /* Diff is only safe while the frame fits the screen. */
+                if (lines < rows) {
+                        size_t i = 0;
+                        size_t line_start = 0;
+
+                        while (i < last && i < prev.len &&
+                                        curr.data[i] == prev.data[i]) {
+                                if (curr.data[i] == '\n') {
+                                        line_start = i + 1;
+                                        ++row;
+                                }
+                                ++i;
+                        }
+
+                        from = line_start;
+                } else {
+                        prev_valid = false;
+                }
+        } else {
+                prev_valid = false;
+        }
+
+        char head[32];
+        int head_len = prev_valid ?
+                snprintf(head, sizeof(head), "\033[%d;1H\033[J", row + 1) :
+                snprintf(head, sizeof(head), "%s", FRAME_CLEAR);
+
+        /* Header goes into the frame buffer, so the frame is one write. */
+        if (!buf_reserve(&curr, head_len))
+                return false;
+
+        memmove(curr.data + from + head_len, curr.data + from,
+                        curr.len - from);
+        memcpy(curr.data + from, head, head_len);
+
+        bool ok = write_all(curr.data + from, curr.len - from + head_len);
+
+        /* Keep the frame without the header as the previous screen. */
+        memmove(curr.data + from, curr.data + from + head_len,
+                        curr.len - from);
+
+        FrameBuf tmp = prev;
+        prev = curr;
+        curr = tmp;
+        curr.len = 0;
+        prev_valid = ok;
+
+        return ok;
+}
+
+void frame_invalidate(void)
+{
+        prev_valid = false;
+}
+
+static bool buf_reserve(FrameBuf *buf, size_t extra)
+{
+        if (buf->len + extra <= buf->cap)
+                return true;
+
+        size_t cap = buf->cap ? buf->cap : 4096;
+
+        while (cap < buf->len + extra)
+                cap *= 2;
+
+        char *data = realloc(buf->data, cap);
+
+        if (data == NULL) {
+                FAIL(ERR_NOMEM, "Out of memory.");
+                return false;
+        }
+
+        buf->data = data;
+        buf->cap = cap;
+        return true;
+}
+
+static bool write_all(const char *data, size_t len)
+{
+        while (len > 0) {
+                ssize_t n = write(STDOUT_FILENO, data, len);
+
+                if (n < 0) {
+                        if (errno == EINTR)
+                                continue;
+                        return false;
+                }
+
+                data += n;
+                len -= n;
+        }
+
+        return true;
+}
+
+static int term_rows(void)
+{
+        struct winsize ws;
+
+        if (!isatty(STDOUT_FILENO) ||
+                        ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) < 0)
+                return 0;
+
+        /* Some pseudo terminals report no size at all. */
+        return ws.ws_row > 0 ? ws.ws_row : FRAME_DEFAULT_ROWS;
+}
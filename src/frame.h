@@ -0,0 +1,95 @@
+/**
+ * @file frame.h
+ * @brief Interface for buffered screen rendering.
+ *
+ * Screen content is rendered into one reusable buffer and emitted with
+ * a single write(). Screens are compared with the previous one line by
+ * line, so only the changed tail of the screen is retransmitted. Long
+ * outputs, such as history listings, are streamed in big chunks instead.
+ *
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include "error.h"
+
+/** ASCII sequence, which clears the screen and moves cursor home. */
+#define FRAME_CLEAR  "\033[2J\033[1;1H"
+
+/** Number of terminal rows assumed when the terminal doesn't tell. */
+#define FRAME_DEFAULT_ROWS 24
+
+/** Size of a chunk written at once by a streamed frame. */
+#define FRAME_CHUNK  65536
+
+/**
+ * @brief Type definition for frame kinds.
+ */
+typedef enum FrameMode_tag {
+        FRAME_SCREEN, ///< Whole screen, diffed against the previous one.
+        FRAME_STREAM ///< Long output, written in chunks after a clear.
+} FrameMode;
+
+/**
+ * @brief Starts a new frame.
+ *
+ * Empties the frame buffer. Everything appended until frame_flush() is
+ * a part of the frame specified by @p mode.
+ *
+ * @param[in] mode Kind of the frame.
+ * @return Nothing.
+ */
+void frame_begin(FrameMode mode);
+
+/**
+ * @brief Appends formatted text to the frame.
+ *
+ * @param[in] fmt Format string, as for printf().
+ * @return Nothing.
+ */
+void frame_printf(const char *fmt, ...);
+
+/**
+ * @brief Appends bytes to the frame.
+ *
+ * @param[in] str Bytes to be appended, not necessarily terminated.
+ * @param[in] len Number of bytes.
+ * @return Nothing.
+ */
+void frame_write(const char *str, size_t len);
+
+/**
+ * @brief Emits the frame.
+ *
+ * A screen frame is compared with the previous screen frame and only
+ * the lines starting from the first changed one are sent, always
+ * including the last line, which holds the prompt. A streamed frame
+ * sends what's left in the buffer.
+ *
+ * @return True on success, or false otherwise.
+ */
+bool frame_flush(void);
+
+/**
+ * @brief Forgets the previous screen frame.
+ *
+ * Must be called whenever the screen is changed bypassing frames, so the
+ * next screen frame is drawn from scratch.
+ *
+ * @return Nothing.
+ */
+void frame_invalidate(void);
+
+#endif
@@ -0,0 +1,308 @@
+/**
+ * @file hindex.c
+ * @brief Function definitions for the history date index.
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#include "hindex.h"
+
+/**
+ * @brief Returns size of the file.
+ * @param[in] fp File pointer.
+ * @return Size of the file in bytes, or -1 on failure.
+ */
+static long file_size(FILE *fp);
+
+/**
+ * @brief Writes index header.
+ * @param[in,out] fp File pointer to the index file.
+ * @param[in] seg_size Size of the segment the index describes.
+ * @return True on success, or false otherwise.
+ */
+static bool write_hdr(FILE *fp, uint64_t seg_size);
+
+/**
+ * @brief Reads and checks index header.
+ * @param[in] fp File pointer to the index file.
+ * @param[in,out] hdr Header, where read values are to be stored.
+ * @return True if header is valid, or false otherwise.
+ */
+static bool read_hdr(FILE *fp, HIndexHdr *hdr);
+
+/**
+ * @brief Compares two index records by date, then by offset.
+ */
+static int cmp_recs(const void *a, const void *b);
+
+bool hindex_sync(Date month)
+{
+        char seg_path[SEGMENT_PATHSIZE] = { 0 };
+        char idx_path[SEGMENT_PATHSIZE] = { 0 };
+        struct stat st;
+
+        segment_path(month, SEGMENT_TEXT, seg_path);
+        segment_path(month, SEGMENT_INDEX, idx_path);
+
+        uint64_t seg_size = stat(seg_path, &st) == 0 ? st.st_size : 0;
+        FILE *idx_fp = fopen(idx_path, "rb");
+        HIndexHdr hdr;
+
+        if (idx_fp != NULL) {
+                bool fresh = read_hdr(idx_fp, &hdr) &&
+                        hdr.seg_size == seg_size &&
+                        (file_size(idx_fp) - sizeof(HIndexHdr)) %
+                        sizeof(HIndexRec) == 0;
+                fclose(idx_fp);
+                idx_fp = NULL;
+
+                if (fresh)
+                        return true;
+        }
+
+        return hindex_rebuild(month);
+}
+
+bool hindex_rebuild(Date month)
+{
+        char seg_path[SEGMENT_PATHSIZE] = { 0 };
+        char idx_path[SEGMENT_PATHSIZE] = { 0 };
+        MapFile history = { NULL, 0 };
+
+        segment_path(month, SEGMENT_TEXT, seg_path);
+        segment_path(month, SEGMENT_INDEX, idx_path);
+
+        /* Missing segment gets an empty index. */
+        if (!map_file(seg_path, &history) && errno != ENOENT) {
+                FAIL(ERR_IO, "Failed to map history segment.");
+                return false;
+        }
+
+        HIndexRec *recs = NULL;
+        size_t size = 0;
+        size_t capacity = 0;
+        const char *pos = history.data;
+        const char *end = history.data + history.size;
+        const char *line = NULL;
+        size_t len = 0;
+
+        while (next_line(&pos, end, &line, &len)) {
+                uint64_t offset = line - history.data;
+                uint32_t length = pos - line;
+                Date key = 0;
+
+                if (len < DATEOFFSET || !date_is_valid(line, &key))
+                        continue;
+
+                if (size > 0 && recs[size - 1].key == key &&
+                                recs[size - 1].offset +
+                                recs[size - 1].length == offset) {
+                        recs[size - 1].length += length;
+                        continue;
+                }
+
+                if (size == capacity) {
+                        capacity = capacity ? capacity * 2 : 64;
+                        HIndexRec *tmp = realloc(recs,
+                                        capacity * sizeof(HIndexRec));
+
+                        if (tmp == NULL) {
+                                FAIL(ERR_NOMEM, "Out of memory.");
+                                free(recs);
+                                unmap_file(&history);
+                                return false;
+                        }
+
+                        recs = tmp;
+                }
+
+                recs[size].key = key;
+                recs[size].length = length;
+                recs[size].offset = offset;
+                ++size;
+        }
+
+        uint64_t seg_size = history.size;
+        unmap_file(&history);
+
+        if (size > 0)
+                qsort(recs, size, sizeof(HIndexRec), cmp_recs);
+
+        FILE *idx_fp = fopen(idx_path, "wb");
+
+        if (idx_fp == NULL) {
+                FAIL(ERR_IO, "Failed to create segment index.");
+                free(recs);
+                return false;
+        }
+
+        bool ok = write_hdr(idx_fp, seg_size) &&
+                fwrite(recs, sizeof(HIndexRec), size, idx_fp) == size;
+
+        if (!ok)
+                FAIL(ERR_IO, "Failed to write segment index.");
+
+        fclose(idx_fp);
+        idx_fp = NULL;
+        free(recs);
+        recs = NULL;
+        return ok;
+}
+
+bool hindex_append(Date key, uint64_t offset, uint32_t length,
+                uint64_t seg_size)
+{
+        char idx_path[SEGMENT_PATHSIZE] = { 0 };
+
+        segment_path(DATE_MONTH_KEY(key), SEGMENT_INDEX, idx_path);
+
+        FILE *idx_fp = fopen(idx_path, "r+b");
+        HIndexHdr hdr;
+
+        if (idx_fp == NULL || !read_hdr(idx_fp, &hdr)) {
+                if (idx_fp)
+                        fclose(idx_fp);
+                return hindex_rebuild(DATE_MONTH_KEY(key));
+        }
+
+        long size = file_size(idx_fp);
+        HIndexRec last = { 0 };
+        bool has_last = size >= (long) (sizeof(HIndexHdr) + sizeof(HIndexRec));
+
+        if (has_last) {
+                fseek(idx_fp, size - sizeof(HIndexRec), SEEK_SET);
+                if (fread(&last, sizeof(HIndexRec), 1, idx_fp) != 1)
+                        has_last = false;
+        }
+
+        if (has_last && last.key > key) {
+                /* Entry breaks date order, so records must be resorted. */
+                fclose(idx_fp);
+                return hindex_rebuild(DATE_MONTH_KEY(key));
+        }
+
+        if (has_last && last.key == key &&
+                        last.offset + last.length == offset) {
+                last.length += length;
+                fseek(idx_fp, size - sizeof(HIndexRec), SEEK_SET);
+        } else {
+                last.key = key;
+                last.offset = offset;
+                last.length = length;
+                fseek(idx_fp, 0L, SEEK_END);
+        }
+
+        bool ok = fwrite(&last, sizeof(HIndexRec), 1, idx_fp) == 1;
+
+        if (ok) {
+                rewind(idx_fp);
+                ok = write_hdr(idx_fp, seg_size);
+        }
+
+        if (!ok)
+                FAIL(ERR_IO, "Failed to update segment index.");
+
+        fclose(idx_fp);
+        idx_fp = NULL;
+        return ok;
+}
+
+long hindex_find(Date key, HIndexRec *recs, long max)
+{
+        if (recs == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> recs == NULL.");
+                return -1;
+        }
+
+        char idx_path[SEGMENT_PATHSIZE] = { 0 };
+
+        segment_path(DATE_MONTH_KEY(key), SEGMENT_INDEX, idx_path);
+
+        FILE *idx_fp = fopen(idx_path, "rb");
+        HIndexHdr hdr;
+
+        if (idx_fp == NULL || !read_hdr(idx_fp, &hdr)) {
+                WARNING("Failed to open segment index.");
+                if (idx_fp)
+                        fclose(idx_fp);
+                return -1;
+        }
+
+        long nrecs = (file_size(idx_fp) - (long) sizeof(HIndexHdr)) /
+                (long) sizeof(HIndexRec);
+        long lo = 0;
+        long hi = nrecs;
+        HIndexRec rec;
+
+        /* Lower bound: first record with rec.key >= key. */
+        while (lo < hi) {
+                long mid = lo + (hi - lo) / 2;
+
+                fseek(idx_fp, sizeof(HIndexHdr) + mid * sizeof(HIndexRec),
+                                SEEK_SET);
+                if (fread(&rec, sizeof(HIndexRec), 1, idx_fp) != 1) {
+                        FAIL(ERR_IO, "Failed to read segment index.");
+                        fclose(idx_fp);
+                        return -1;
+                }
+
+                if (rec.key < key)
+                        lo = mid + 1;
+                else
+                        hi = mid;
+        }
+
+        long count = 0;
+
+        fseek(idx_fp, sizeof(HIndexHdr) + lo * sizeof(HIndexRec), SEEK_SET);
+        while (count < max && fread(&rec, sizeof(HIndexRec), 1, idx_fp) == 1 &&
+                        rec.key == key)
+                recs[count++] = rec;
+
+        fclose(idx_fp);
+        idx_fp = NULL;
+        return count;
+}
+
+static long file_size(FILE *fp)
+{
+        if (fseek(fp, 0L, SEEK_END) != 0)
+                return -1;
+
+        long size = ftell(fp);
+        rewind(fp);
+        return size;
+}
+
+static bool write_hdr(FILE *fp, uint64_t seg_size)
+{
+        HIndexHdr hdr = { { 0 }, HINDEX_VERSION, seg_size };
+        memcpy(hdr.magic, HINDEX_MAGIC, sizeof(hdr.magic));
+
+        return fwrite(&hdr, sizeof(HIndexHdr), 1, fp) == 1;
+}
+
+static bool read_hdr(FILE *fp, HIndexHdr *hdr)
+{
+        rewind(fp);
+
+        if (fread(hdr, sizeof(HIndexHdr), 1, fp) != 1)
+                return false;
+
+        return memcmp(hdr->magic, HINDEX_MAGIC, sizeof(hdr->magic)) == 0 &&
+                hdr->version == HINDEX_VERSION;
+}
+
+static int cmp_recs(const void *a, const void *b)
+{
+        const HIndexRec *ra = a;
+        const HIndexRec *rb = b;
+
+        if (ra->key != rb->key)
+                return ra->key < rb->key ? -1 : 1;
+
+        if (ra->offset != rb->offset)
+                return ra->offset < rb->offset ? -1 : 1;
+
+        return 0;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file hindex.h
+ * @brief Interface for the history date index.
+ *
+ * Every history segment has an index file next to it. The index holds
+ * a small header followed by fixed-size records sorted by date, one record
+ * per run of segment lines with the same date. Offsets are local to the
+ * segment. Looking an entry up is a binary search over the records of its
+ * month plus one bounded read from the segment.
+ *
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#ifndef HINDEX_H
+#define HINDEX_H
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "date.h"
+#include "error.h"
+#include "history.h"
+#include "mapfile.h"
+#include "types.h"
+
+/** Magic bytes at the start of the index file. */
+#define HINDEX_MAGIC   "DIDX"
+
+/** Version of the index file layout. */
+#define HINDEX_VERSION 2
+
+/**
+ * @brief Type definition for the index file header.
+ */
+typedef struct HIndexHdr_tag {
+        char     magic[4]; ///< HINDEX_MAGIC.
+        uint32_t version; ///< HINDEX_VERSION.
+        uint64_t seg_size; ///< Size of the segment the index describes.
+} HIndexHdr;
+
+/**
+ * @brief Type definition for the index record.
+ */
+typedef struct HIndexRec_tag {
+        Date     key; ///< Entry date.
+        uint32_t length; ///< Length of the entry in bytes.
+        uint64_t offset; ///< Offset of the entry in the segment.
+} HIndexRec;
+
+/**
+ * @brief Makes sure the index describes current segment.
+ *
+ * Compares the segment size stored in the index header with the actual
+ * size of the segment specified by @p month and rebuilds the index if they
+ * differ or if the index is missing or damaged.
+ *
+ * @param[in] month Month key of the segment.
+ * @return True on success, or false otherwise.
+ */
+bool hindex_sync(Date month);
+
+/**
+ * @brief Rebuilds the index from the segment.
+ *
+ * Maps the segment specified by @p month, scans it once, collects runs of
+ * lines with the same date and writes them sorted by date into a fresh
+ * index file.
+ *
+ * @param[in] month Month key of the segment.
+ * @return True on success, or false otherwise.
+ */
+bool hindex_rebuild(Date month);
+
+/**
+ * @brief Adds record to the index.
+ *
+ * Appends record to the index of the segment @p key belongs to, specified
+ * by @p key, @p offset and @p length. If the record continues the last
+ * one, they are merged. If the record breaks the date order, the whole
+ * index is rebuilt instead. @p seg_size is the size of the segment after
+ * the entry was appended.
+ *
+ * @param[in] key Entry date.
+ * @param[in] offset Offset of the entry in the segment.
+ * @param[in] length Length of the entry in bytes.
+ * @param[in] seg_size Size of the segment after the append.
+ * @return True on success, or false otherwise.
+ */
+bool hindex_append(Date key, uint64_t offset, uint32_t length,
+                uint64_t seg_size);
+
+/**
+ * @brief Searches the index for a date.
+ *
+ * Binary searches the index of the segment @p key belongs to for records
+ * with the date specified by @p key and copies at most @p max of them into
+ * @p recs. It's responsibility of the caller to provide memory for
+ * @p recs.
+ *
+ * @param[in] key Date which is to be found.
+ * @param[in,out] recs Array, where found records are to be stored.
+ * @param[in] max Number of records @p recs can hold.
+ * @return Number of found records, or -1 on failure.
+ */
+long hindex_find(Date key, HIndexRec *recs, long max);
+
+#endif
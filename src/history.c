@@ -0,0 +1,659 @@
+/**
+ * @file history.c
+ * @brief Function definitions for the segmented task history.
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "archive.h"
+#include "date.h"
+#include "error.h"
+#include "hindex.h"
+#include "history.h"
+#include "mapfile.h"
+#include "store.h"
+#include "windex.h"
+
+/**
+ * @brief Reads manifest file.
+ * @param[in,out] man Pointer to the empty manifest.
+ * @param[in] path Name of the file, which may be missing.
+ * @return True on success, or false otherwise.
+ */
+static bool read_manifest(Manifest *man, const char *path);
+
+/**
+ * @brief Writes manifest file atomically.
+ * @param[in] man Pointer to the read-only manifest.
+ * @param[in] path Name of the file.
+ * @return True on success, or false otherwise.
+ */
+static bool write_manifest(const Manifest *man, const char *path);
+
+/**
+ * @brief Removes all the files of the segment of @p month.
+ * @return True on success, or false otherwise.
+ */
+static bool remove_segment(Date month);
+
+/**
+ * @brief Undoes an interrupted move of history.txt.
+ *
+ * Cuts segment files back to the sizes listed in @p before and removes
+ * segments which aren't listed there, with indexes and summaries of
+ * both, so they're rebuilt. Segments of @p before move into @p man.
+ *
+ * @param[in,out] man Pointer to the manifest.
+ * @param[in,out] before Pointer to the manifest from before.
+ * @return True on success, or false otherwise.
+ */
+static bool undo_migration(Manifest *man, Manifest *before);
+
+/**
+ * @brief Adds segment to the manifest.
+ *
+ * Keeps segments sorted by month. Does nothing if the segment is already
+ * listed.
+ *
+ * @param[in,out] man Pointer to the manifest.
+ * @param[in] month Month key of the segment.
+ * @return Pointer to the segment, or NULL on failure.
+ */
+static Segment *add_segment(Manifest *man, Date month);
+
+/**
+ * @brief Opens segment for appending.
+ *
+ * Adds the segment to the manifest and saves the manifest before the
+ * segment is written, so every segment on disk is listed.
+ *
+ * @param[in,out] man Pointer to the manifest.
+ * @param[in] month Month key of the segment.
+ * @param[in,out] fp Pointer, where the segment file is to be stored.
+ * @param[in,out] offset Pointer, where the segment size is to be stored.
+ * @return Pointer to the segment, or NULL on failure.
+ */
+static Segment *open_segment(Manifest *man, Date month, FILE **fp,
+                uint64_t *offset);
+
+/**
+ * @brief Moves history.txt of older versions into segments.
+ * @param[in,out] man Pointer to the manifest.
+ * @return True on success, or false otherwise.
+ */
+static bool migrate_history(Manifest *man);
+
+bool history_open(Manifest *man)
+{
+        if (man == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> man == NULL.");
+                return false;
+        }
+
+        man->segs = NULL;
+        man->size = 0;
+        man->capacity = 0;
+        man->stamp = 0;
+
+        if (mkdir(HISTORY_DIR, 0755) < 0 && errno != EEXIST) {
+                FAIL(ERR_IO, "Failed to create history directory.");
+                return false;
+        }
+
+        if (!read_manifest(man, HISTORY_MANIFEST))
+                return false;
+
+        if (access(HISTORY, F_OK) == 0 && !migrate_history(man)) {
+                WARNING("Failed to move history.txt into segments.");
+                history_close(man);
+                return false;
+        }
+
+        /* Move, which got as far as removing history.txt, is done. */
+        if (unlink(HISTORY_MIGRATION) < 0 && errno != ENOENT)
+                FAIL(ERR_IO, "Failed to remove history migration file.");
+
+        Date today = 0;
+
+        get_curr_date(&today);
+
+        for (long i = 0; i < man->size; i++) {
+                char path[SEGMENT_PATHSIZE] = { 0 };
+                struct stat st;
+
+                if (man->segs[i].month < DATE_MONTH_KEY(today) &&
+                                !archive_segment(man->segs[i].month))
+                        WARNING("Failed to archive history segment.");
+
+                /* Sizes in the manifest may lag behind after a crash. */
+                segment_path(man->segs[i].month, SEGMENT_TEXT, path);
+                man->segs[i].size = stat(path, &st) == 0 ? st.st_size : 0;
+        }
+
+        return true;
+}
+
+void history_close(Manifest *man)
+{
+        if (man == NULL)
+                return;
+
+        free(man->segs);
+        man->segs = NULL;
+        man->size = 0;
+        man->capacity = 0;
+}
+
+bool history_save(const Manifest *man)
+{
+        if (man == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> man == NULL.");
+                return false;
+        }
+
+        return write_manifest(man, HISTORY_MANIFEST);
+}
+
+static bool write_manifest(const Manifest *man, const char *path)
+{
+        /* First line is "stamp N\n", every next one is "yyyy-mm size\n". */
+        size_t size = (man->size + 1) * (8 + 21 + 1) + 1;
+        char *buf = malloc(size);
+
+        if (buf == NULL) {
+                FAIL(ERR_NOMEM, "Out of memory.");
+                return false;
+        }
+
+        size_t len = snprintf(buf, size, "stamp %" PRIu64 "\n", man->stamp);
+
+        for (long i = 0; i < man->size; i++)
+                len += snprintf(buf + len, size - len, "%04u-%02u %" PRIu64
+                                "\n", DATE_YEAR(man->segs[i].month),
+                                DATE_MONTH(man->segs[i].month),
+                                man->segs[i].size);
+
+        bool ok = store_file(path, buf, len);
+
+        free(buf);
+        buf = NULL;
+        return ok;
+}
+
+Segment *history_find(const Manifest *man, Date month)
+{
+        if (man == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> man == NULL.");
+                return NULL;
+        }
+
+        long lo = 0;
+        long hi = man->size;
+
+        while (lo < hi) {
+                long mid = lo + (hi - lo) / 2;
+
+                if (man->segs[mid].month < month)
+                        lo = mid + 1;
+                else
+                        hi = mid;
+        }
+
+        return lo < man->size && man->segs[lo].month == month ?
+                &man->segs[lo] : NULL;
+}
+
+bool history_append(Manifest *man, FILE *fp)
+{
+        if (man == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> man == NULL.");
+                return false;
+        }
+
+        if (fp == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> fp == NULL.");
+                return false;
+        }
+
+        WIndex words;
+
+        /*
+         * Stamp is saved before segments change and sealed into the word
+         * index after, so index which missed a change is found stale.
+         */
+        bool indexed = windex_open(&words, man);
+
+        if (!indexed)
+                WARNING("Failed to open word index.");
+
+        ++man->stamp;
+
+        if (!history_save(man)) {
+                if (indexed)
+                        windex_close(&words, 0);
+                return false;
+        }
+
+        char *line = NULL;
+        size_t line_size = 0;
+        ssize_t len = 0;
+        FILE *seg_fp = NULL;
+        Segment *seg = NULL;
+        uint64_t offset = 0;
+        uint64_t run_offset = 0;
+        Date run_key = 0;
+        bool ok = true;
+
+        /* Whole lines, so every word of a long subject gets indexed. */
+        while (ok && (len = getline(&line, &line_size, fp)) > 0) {
+                Date key = 0;
+
+                if (len < DATEOFFSET || !date_is_valid(line, &key))
+                        key = 0;
+
+                if (key != run_key) {
+                        /* Index may be rebuilt from the file, so flush it. */
+                        if (run_key != 0 && fflush(seg_fp) != 0)
+                                ok = false;
+                        else if (run_key != 0)
+                                hindex_append(run_key, run_offset,
+                                                offset - run_offset, offset);
+
+                        if (ok && key != 0 && (seg == NULL ||
+                                        seg->month != DATE_MONTH_KEY(key))) {
+                                if (seg_fp != NULL) {
+                                        ok = fclose(seg_fp) == 0;
+                                        seg_fp = NULL;
+
+                                        if (ok)
+                                                seg->size = offset;
+                                }
+
+                                if (ok)
+                                        seg = open_segment(man,
+                                                        DATE_MONTH_KEY(key),
+                                                        &seg_fp, &offset);
+                                ok = ok && seg != NULL;
+                        }
+
+                        run_key = key;
+                        run_offset = offset;
+                }
+
+                /* Lines without a date before the first entry are dropped. */
+                if (!ok || seg_fp == NULL)
+                        continue;
+
+                if (fwrite(line, 1, len, seg_fp) != (size_t) len) {
+                        ok = false;
+                        continue;
+                }
+
+                offset += len;
+
+                if (indexed && key != 0 && !windex_add(&words, line, len))
+                        indexed = false;
+        }
+
+        free(line);
+        line = NULL;
+
+        if (ferror(fp))
+                ok = false;
+
+        if (seg_fp != NULL) {
+                if (fclose(seg_fp) != 0)
+                        ok = false;
+                seg_fp = NULL;
+
+                /* Manifest never claims bytes which didn't reach the disk. */
+                if (ok)
+                        seg->size = offset;
+
+                if (ok && run_key != 0)
+                        hindex_append(run_key, run_offset,
+                                        offset - run_offset, offset);
+        }
+
+        if (!ok)
+                FAIL(ERR_IO, "Failed to write history segment.");
+
+        /* Index which missed some lines is rebuilt next time. */
+        if (words.fd >= 0)
+                windex_close(&words, ok && indexed ? man->stamp : 0);
+
+        return history_save(man) && ok;
+}
+
+bool history_erase(Manifest *man)
+{
+        if (man == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> man == NULL.");
+                return false;
+        }
+
+        bool ok = true;
+
+        for (long i = 0; i < man->size; i++)
+                if (!remove_segment(man->segs[i].month))
+                        ok = false;
+
+        if (unlink(WINDEX_FILE) < 0 && errno != ENOENT)
+                ok = false;
+
+        man->size = 0;
+        ++man->stamp;
+
+        if (!ok)
+                FAIL(ERR_IO, "Failed to remove history segment.");
+
+        return history_save(man) && ok;
+}
+
+bool history_read_day(const Manifest *man, Date key, char **buf,
+                size_t *len)
+{
+        if (man == NULL || buf == NULL || len == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> NULL pointer.");
+                return false;
+        }
+
+        *buf = NULL;
+        *len = 0;
+
+        Date month = DATE_MONTH_KEY(key);
+
+        if (history_find(man, month) == NULL)
+                return true;
+
+        if (!archive_read(month, key, buf, len)) {
+                WARNING("Failed to read history archive.");
+                return false;
+        }
+
+        char path[SEGMENT_PATHSIZE] = { 0 };
+        MapFile segment = { NULL, 0 };
+        HIndexRec *recs = NULL;
+        long max = SEARCH_MAX_RUNS;
+        long nrecs = 0;
+
+        segment_path(month, SEGMENT_TEXT, path);
+
+        if (!map_file(path, &segment)) {
+                if (errno == ENOENT)
+                        return true;
+
+                FAIL(ERR_IO, "Failed to map history segment.");
+                goto fail;
+        }
+
+        if (segment.size > 0 && !hindex_sync(month))
+                nrecs = -1;
+
+        /* Full array may have cut runs off, so it's searched with more room. */
+        while (segment.size > 0 && nrecs >= 0) {
+                HIndexRec *tmp = realloc(recs, max * sizeof(HIndexRec));
+
+                if (tmp == NULL) {
+                        FAIL(ERR_NOMEM, "Out of memory.");
+                        goto fail;
+                }
+
+                recs = tmp;
+                nrecs = hindex_find(key, recs, max);
+
+                if (nrecs < max)
+                        break;
+
+                max *= 2;
+        }
+
+        if (nrecs < 0) {
+                WARNING("Failed to search history index.");
+                goto fail;
+        }
+
+        for (long i = 0; i < nrecs; i++) {
+                if (recs[i].offset + recs[i].length > segment.size)
+                        continue;
+
+                char *tmp = realloc(*buf, *len + recs[i].length);
+
+                if (tmp == NULL) {
+                        FAIL(ERR_NOMEM, "Out of memory.");
+                        goto fail;
+                }
+
+                *buf = tmp;
+                memcpy(*buf + *len, segment.data + recs[i].offset,
+                                recs[i].length);
+                *len += recs[i].length;
+        }
+
+        free(recs);
+        unmap_file(&segment);
+        return true;
+
+fail:
+        free(recs);
+        unmap_file(&segment);
+        free(*buf);
+        *buf = NULL;
+        *len = 0;
+        return false;
+}
+
+void segment_path(Date month, const char *ext, char *path)
+{
+        snprintf(path, SEGMENT_PATHSIZE, "%s/%04u-%02u%s", HISTORY_DIR,
+                        DATE_YEAR(month), DATE_MONTH(month), ext);
+}
+
+static bool read_manifest(Manifest *man, const char *path)
+{
+        FILE *fp = fopen(path, "r");
+
+        if (fp == NULL)
+                return errno == ENOENT;
+
+        unsigned year = 0;
+        unsigned month = 0;
+        uint64_t size = 0;
+        bool ok = true;
+
+        /* Manifests of older versions have no stamp. */
+        if (fscanf(fp, " stamp %" SCNu64, &man->stamp) != 1)
+                man->stamp = 0;
+
+        while (ok && fscanf(fp, "%u-%u %" SCNu64, &year, &month,
+                                &size) == 3) {
+                Segment *seg = add_segment(man, DATE_PACK(0, month, year));
+
+                ok = seg != NULL;
+
+                if (ok)
+                        seg->size = size;
+        }
+
+        fclose(fp);
+        fp = NULL;
+        return ok;
+}
+
+static Segment *add_segment(Manifest *man, Date month)
+{
+        Segment *seg = history_find(man, month);
+
+        if (seg != NULL)
+                return seg;
+
+        if (man->size == man->capacity) {
+                long capacity = man->capacity ? man->capacity * 2 : 16;
+                Segment *segs = realloc(man->segs,
+                                capacity * sizeof(Segment));
+
+                if (segs == NULL) {
+                        FAIL(ERR_NOMEM, "Out of memory.");
+                        return NULL;
+                }
+
+                man->segs = segs;
+                man->capacity = capacity;
+        }
+
+        long pos = man->size;
+
+        while (pos > 0 && man->segs[pos - 1].month > month) {
+                man->segs[pos] = man->segs[pos - 1];
+                --pos;
+        }
+
+        man->segs[pos].month = month;
+        man->segs[pos].size = 0;
+        ++man->size;
+        return &man->segs[pos];
+}
+
+static Segment *open_segment(Manifest *man, Date month, FILE **fp,
+                uint64_t *offset)
+{
+        char path[SEGMENT_PATHSIZE] = { 0 };
+        long size = man->size;
+        Segment *seg = add_segment(man, month);
+
+        *fp = NULL;
+
+        if (seg == NULL || (man->size != size && !history_save(man)))
+                return NULL;
+
+        if (!hindex_sync(month))
+                WARNING("Failed to sync segment index.");
+
+        segment_path(month, SEGMENT_TEXT, path);
+        *fp = fopen(path, "a");
+
+        if (*fp == NULL)
+                return NULL;
+
+        fseek(*fp, 0L, SEEK_END);
+        *offset = ftell(*fp);
+        return seg;
+}
+
+static bool remove_segment(Date month)
+{
+        static const char *exts[] = { SEGMENT_TEXT, SEGMENT_INDEX,
+                SEGMENT_SUMMARY, SEGMENT_ARCHIVE, SEGMENT_PACKING };
+        bool ok = true;
+
+        for (size_t i = 0; i < sizeof(exts) / sizeof(exts[0]); i++) {
+                char path[SEGMENT_PATHSIZE] = { 0 };
+
+                segment_path(month, exts[i], path);
+                if (unlink(path) < 0 && errno != ENOENT)
+                        ok = false;
+        }
+
+        return ok;
+}
+
+static bool undo_migration(Manifest *man, Manifest *before)
+{
+        bool ok = true;
+
+        for (long i = 0; i < man->size; i++) {
+                Date month = man->segs[i].month;
+                Segment *old = history_find(before, month);
+                char path[SEGMENT_PATHSIZE] = { 0 };
+
+                if (old == NULL) {
+                        if (!remove_segment(month))
+                                ok = false;
+                        continue;
+                }
+
+                segment_path(month, SEGMENT_TEXT, path);
+                if (old->size == 0 ? unlink(path) < 0 && errno != ENOENT :
+                                truncate(path, old->size) < 0)
+                        ok = false;
+
+                segment_path(month, SEGMENT_INDEX, path);
+                if (unlink(path) < 0 && errno != ENOENT)
+                        ok = false;
+
+                segment_path(month, SEGMENT_SUMMARY, path);
+                if (unlink(path) < 0 && errno != ENOENT)
+                        ok = false;
+        }
+
+        if (!ok)
+                return false;
+
+        /* Newer stamp makes the word index stale, so it's rebuilt. */
+        free(man->segs);
+        man->segs = before->segs;
+        man->size = before->size;
+        man->capacity = before->capacity;
+        before->segs = NULL;
+        before->size = before->capacity = 0;
+        ++man->stamp;
+        return history_save(man);
+}
+
+static bool migrate_history(Manifest *man)
+{
+        Manifest before = { NULL, 0, 0, 0 };
+        bool ok = true;
+
+        /*
+         * Sizes of the segments are noted before the move starts, so an
+         * interrupted move is undone and started over, and segments which
+         * were there before it are kept.
+         */
+        if (access(HISTORY_MIGRATION, F_OK) == 0) {
+                ok = read_manifest(&before, HISTORY_MIGRATION) &&
+                        undo_migration(man, &before);
+        } else {
+                for (long i = 0; ok && i < man->size; i++) {
+                        char path[SEGMENT_PATHSIZE] = { 0 };
+                        struct stat st;
+                        Segment *seg = add_segment(&before, man->segs[i].month);
+
+                        segment_path(man->segs[i].month, SEGMENT_TEXT, path);
+                        ok = seg != NULL;
+
+                        if (ok)
+                                seg->size = stat(path, &st) == 0 ?
+                                        st.st_size : 0;
+                }
+
+                ok = ok && write_manifest(&before, HISTORY_MIGRATION);
+        }
+
+        history_close(&before);
+
+        if (!ok)
+                return false;
+
+        FILE *fp = fopen(HISTORY, "r");
+
+        if (fp == NULL)
+                return false;
+
+        ok = history_append(man, fp);
+
+        fclose(fp);
+        fp = NULL;
+
+        if (!ok)
+                return false;
+
+        unlink(HISTORY_IDX);
+        return unlink(HISTORY) == 0;
+}
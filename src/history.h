@@ -0,0 +1,172 @@
+/**
+ * @file history.h
+ * @brief Interface for the segmented task history.
+ *
+ * History is split into one segment file per month, ./txt/history/
+ * YYYY-MM.txt, each with its own date index next to it. The manifest lists
+ * segments in date order, so listing walks the segments one by one and
+ * searching opens only the segment of the searched month. Segments of past
+ * months are never rewritten when new entries are saved; once the month is
+ * over they are packed into block-compressed archives, see archive.h.
+ *
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "types.h"
+
+/** Directory which contains history segments. */
+#define HISTORY_DIR      (list_paths()->history_dir)
+
+/** Address and name of the file which lists history segments. */
+#define HISTORY_MANIFEST (list_paths()->manifest)
+
+/**
+ * Address and name of the file which lists segment sizes from before
+ * history.txt started to move into segments. It's there only while
+ * the move is going on.
+ */
+#define HISTORY_MIGRATION (list_paths()->migration)
+
+/** Extension of the segment file with tasks. */
+#define SEGMENT_TEXT     ".txt"
+
+/** Extension of the segment date index file. */
+#define SEGMENT_INDEX    ".idx"
+
+/** Extension of the segment summary file. */
+#define SEGMENT_SUMMARY  ".sum"
+
+/** Extension of the archive of a closed segment. */
+#define SEGMENT_ARCHIVE  ".dz"
+
+/** Extension of the segment file while it's merged into the archive. */
+#define SEGMENT_PACKING  ".pack"
+
+/** Size of the buffer for a segment file name. */
+#define SEGMENT_PATHSIZE 128
+
+/**
+ * Number of separate history runs first looked up for one date. Room is
+ * doubled until all the runs of the date fit.
+ */
+#define SEARCH_MAX_RUNS  16
+
+/**
+ * @brief Type definition for the history segment.
+ */
+typedef struct Segment_tag {
+        Date     month; ///< Month key of the segment, see DATE_MONTH_KEY().
+        uint64_t size; ///< Size of the not archived segment file in bytes.
+} Segment;
+
+/**
+ * @brief Type definition for the list of history segments.
+ */
+typedef struct Manifest_tag {
+        Segment  *segs; ///< Array of segments sorted by month.
+        long     size; ///< Number of segments.
+        long     capacity; ///< Number of segments the array can hold.
+        uint64_t stamp; ///< Number of changes made to history so far.
+} Manifest;
+
+/**
+ * @brief Opens history.
+ *
+ * Creates the history directory if needed, moves the single-file
+ * history.txt of older versions into segments, reads the manifest into
+ * @p man and archives segments of months which are over. Manifest must be
+ * released with history_close().
+ *
+ * @param[in,out] man Pointer to the manifest, which is to be set.
+ * @return True on success, or false otherwise.
+ */
+bool history_open(Manifest *man);
+
+/**
+ * @brief Releases manifest.
+ *
+ * @param[in,out] man Pointer to the manifest.
+ * @return Nothing.
+ */
+void history_close(Manifest *man);
+
+/**
+ * @brief Writes manifest.
+ *
+ * Atomically replaces the manifest file with the content of @p man.
+ *
+ * @param[in] man Pointer to the read-only manifest.
+ * @return True on success, or false otherwise.
+ */
+bool history_save(const Manifest *man);
+
+/**
+ * @brief Finds segment.
+ *
+ * @param[in] man Pointer to the read-only manifest.
+ * @param[in] month Month key of the segment.
+ * @return Pointer to the segment, or NULL if there is none.
+ */
+Segment *history_find(const Manifest *man, Date month);
+
+/**
+ * @brief Appends lines to history.
+ *
+ * Reads history lines from @p fp and appends every run of lines to the
+ * segment of its month, creating segments and updating their indexes,
+ * the word index and the manifest on the way.
+ *
+ * @param[in,out] man Pointer to the manifest.
+ * @param[in] fp Pointer to the file with history lines.
+ * @return True on success, or false otherwise.
+ */
+bool history_append(Manifest *man, FILE *fp);
+
+/**
+ * @brief Reads history lines of a date.
+ *
+ * Collects the archive blocks and the segment runs which may hold lines
+ * with the date specified by @p key into a newly allocated buffer. Lines
+ * of other dates may come along, so the caller must check line dates.
+ * It's responsibility of the caller to free the buffer.
+ *
+ * @param[in] man Pointer to the read-only manifest.
+ * @param[in] key Date which is to be read.
+ * @param[in,out] buf Pointer, where the buffer is to be stored, or NULL.
+ * @param[in,out] len Pointer, where the buffer length is to be stored.
+ * @return True on success, or false otherwise.
+ */
+bool history_read_day(const Manifest *man, Date key, char **buf,
+                size_t *len);
+
+/**
+ * @brief Removes all segments together with their archives.
+ *
+ * @param[in,out] man Pointer to the manifest.
+ * @return True on success, or false otherwise.
+ */
+bool history_erase(Manifest *man);
+
+/**
+ * @brief Makes segment file name.
+ *
+ * Stores the name of the segment file for @p month with the extension
+ * @p ext into @p path, which must hold SEGMENT_PATHSIZE characters.
+ *
+ * @param[in] month Month key of the segment.
+ * @param[in] ext Read-only string with the file extension.
+ * @param[in,out] path String, where the name is to be stored.
+ * @return Nothing.
+ */
+void segment_path(Date month, const char *ext, char *path);
+
+#endif
@@ -7,12 +7,114 @@
 
 #include "io.h"
 
-static void print_taskline(long index, bool status, char *subject);
+static void print_taskline(long index, bool status, const char *subject,
+                int len);
+
+/**
+ * @brief Type definition for the running totals of a history listing.
+ */
+typedef struct ListTotals_tag {
+        Date prev_date; ///< Date of the last printed entry.
+        int  entries_sum; ///< Number of printed entries.
+        int  tasks_sum; ///< Number of printed tasks of the last entry.
+        long tasks; ///< Number of all printed tasks.
+        long done; ///< Number of printed done tasks.
+} ListTotals;
+
+/**
+ * @brief Checks if task matches history query.
+ * @param[in] view Pointer to the read-only task.
+ * @param[in] arg Pointer to the read-only HistoryQuery.
+ * @return True if the task matches, or false otherwise.
+ */
+static bool match_query(const TaskView *view, const void *arg);
+
+/**
+ * @brief Prints history task grouped by entries.
+ * @param[in] view Pointer to the read-only task.
+ * @param[in,out] arg Pointer to the running ListTotals.
+ * @return Nothing.
+ */
+static void show_line(const TaskView *view, void *arg);
+
+/**
+ * @brief Prints history lines which match the query.
+ *
+ * Walks the segments of the query range in one pass, prints matching tasks
+ * grouped by entries and finishes with the totals.
+ *
+ * @param[in] query Pointer to the read-only query.
+ * @return True on success, or false otherwise.
+ */
+static bool list_history(const HistoryQuery *query);
+
+/**
+ * @brief Prints statistics of the date range.
+ * @param[in] from First date of the range.
+ * @param[in] to Last date of the range.
+ * @param[in] period Period the statistics are grouped by.
+ * @return True on success, or false otherwise.
+ */
+static bool show_stats(Date from, Date to, Period period);
+
+/**
+ * @brief Asks for a date with a prompt.
+ * @param[in] entry Pointer to the task list.
+ * @param[in] prompt Read-only string with the prompt.
+ * @param[in,out] date Pointer, where the date will be stored.
+ * @return True on success, or false otherwise.
+ */
+static bool ask_date(Tasks *entry, const char *prompt, Date *date);
+
+/**
+ * @brief Prints history lines with the date.
+ * @param[in] data Lines of a history segment, may be NULL if @p size is 0.
+ * @param[in] size Size of the lines in bytes.
+ * @param[in] key Date of the lines which are to be printed.
+ * @param[in,out] count Number of printed tasks.
+ * @return Nothing.
+ */
+static void search_lines(const char *data, size_t size, Date key,
+                long *count);
+
+/**
+ * @brief Prints history lines with the date which have all the words.
+ *
+ * Date header is printed before the first matching line.
+ *
+ * @param[in] data Lines of a history segment, may be NULL if @p size is 0.
+ * @param[in] size Size of the lines in bytes.
+ * @param[in] key Date of the lines which are to be printed.
+ * @param[in] words Hashes of the words, see next_word().
+ * @param[in] nwords Number of the words.
+ * @param[in,out] total Number of entries printed so far.
+ * @return Nothing.
+ */
+static void find_lines(const char *data, size_t size, Date key,
+                const uint64_t *words, long nwords, long *total);
+
+/**
+ * @brief Finds dates of entries with all the words.
+ * @param[in] man Pointer to the read-only manifest.
+ * @param[in] words Hashes of the words, see next_word().
+ * @param[in] nwords Number of the words, at least one.
+ * @param[in,out] dates Pointer, where the array of dates is to be stored.
+ * @return Number of dates, newest first, or -1 on failure.
+ */
+static long find_dates(const Manifest *man, const uint64_t *words,
+                long nwords, Date **dates);
+
+/**
+ * @brief Compares two dates, the later comes first.
+ */
+static int cmp_dates_desc(const void *a, const void *b);
 
 void clear_scr(void)
 {
         printf("\033[2J");
         printf("\033[1;1H");
+        fflush(stdout);
+        frame_invalidate();
 }
 
 void clear_buf(void)
@@ -23,18 +125,21 @@ void clear_buf(void)
 
 void show_opts(void)
 {
-        clear_scr();
         do {
-                printf("available options:\n"
+                frame_begin(FRAME_STREAM);
+                frame_printf("available options:\n"
                                 "------------------\n"
                                 " a: add task\n"
                                 " c: change task\n"
                                 " d: delete task\n"
                                 " D: delete all tasks\n"
                                 " e: erase history\n"
+                                " f: find in history\n"
                                 " h: help\n"
                                 " l: list history\n"
+                                " L: switch list\n"
                                 " q: quit the program\n"
+                                " r: query history by date range\n"
                                 " s: search history by date\n"
                                 " u: undo task\n"
                                 " U: undo all tasks\n"
@@ -42,9 +147,35 @@ void show_opts(void)
                                 " X: do all tasks\n"
                                 "------------------\n"
                                 "press <Enter> to go back...");
+                frame_flush();
         } while (getchar() != '\n');
 }
 
+bool show_reports(const char *prompt)
+{
+        static uint64_t seq = 0;
+        ErrRecord rec;
+        char text[ERR_MSGSIZE + 256];
+        bool found = false;
+
+        while (err_ring_next(&seq, &rec)) {
+                if (!found)
+                        frame_begin(FRAME_STREAM);
+
+                found = true;
+                err_format(&rec, text, sizeof(text));
+                frame_printf("\n%s", text);
+        }
+
+        if (!found)
+                return false;
+
+        frame_printf("\n%s", prompt);
+        frame_flush();
+        clear_buf();
+        return true;
+}
+
 char *get_valid_opts(const Tasks *entry)
 {
         return tasks_size(entry) == 0 ? OPTIONS1 : OPTIONS2;
@@ -65,24 +196,26 @@ int get_char(void)
 int get_opt(Tasks *entry, const char *opts)
 {
         if (entry == NULL) {
-                WARNING("Bad parameter -> entry == NULL.");
+                FAIL(ERR_PARAM, "Bad parameter -> entry == NULL.");
                 return -1;
         }
 
         if (opts == NULL) {
-                WARNING("Bad parameter -> opts == NULL.");
+                FAIL(ERR_PARAM, "Bad parameter -> opts == NULL.");
                 return -1;
         }
 
         int option = 0;
 
         do {
-                show_tasks(entry);
-
                 if (STRCMP(opts, ==, "yn"))
-                        printf("Are you sure? <y/n>: ");
+                        show_prompt(entry, "Are you sure? <y/n>: ");
+                else if (STRCMP(opts, ==, QUERY_OPTIONS))
+                        show_prompt(entry, "show <a>ll, <x> done, <u>ndone "
+                                        "or stats by <d>ay, <w>eek, "
+                                        "<m>onth: ");
                 else
-                        printf("action: ");
+                        show_prompt(entry, "action: ");
 
                 option = get_char();
         } while (!opt_is_valid(opts, option));
@@ -93,7 +226,7 @@ int get_opt(Tasks *entry, const char *opts)
 bool opt_is_valid(const char *opts, char opt)
 {
         if (opts == NULL) {
-                WARNING("Bad parameter -> opts == NULL.");
+                FAIL(ERR_PARAM, "Bad parameter -> opts == NULL.");
                 return false;
         }
 
@@ -102,26 +235,34 @@ bool opt_is_valid(const char *opts, char opt)
 
 long get_long(void)
 {
-        char str[3];
+        char *str = get_line(stdin);
 
-        if (get_str(str, sizeof(str), stdin))
-                return strtol(str, NULL, 10);
-        else
+        if (str == NULL)
                 return -1L;
+
+        char *end = NULL;
+
+        errno = 0;
+        long num = strtol(str, &end, 10);
+        bool ok = end != str && *end == '\0' && errno == 0 && num >= 0;
+
+        free(str);
+        str = NULL;
+
+        return ok ? num : -1L;
 }
 
 long get_index(Tasks *entry)
 {
         if (entry == NULL) {
-                WARNING("Bad parameter -> entry == NULL.");
+                FAIL(ERR_PARAM, "Bad parameter -> entry == NULL.");
                 return -1L;
         }
 
         long task_index = 0L;
 
         do {
-                show_tasks(entry);
-                printf("index: ");
+                show_prompt(entry, "index: ");
                 task_index = get_long();
         } while (!index_is_valid(task_index, entry));
 
@@ -129,30 +270,100 @@ long get_index(Tasks *entry)
         return task_index;
 }
 
+bool get_task(Tasks *entry)
+{
+        if (entry == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> entry == NULL.");
+                return false;
+        }
+
+        show_prompt(entry, "task: ");
+
+        char *subject = get_line(stdin);
+
+        if (subject == NULL)
+                return false;
+
+        bool ok = add_task(entry, subject, UNDONE);
+
+        free(subject);
+        subject = NULL;
+        return ok;
+}
+
+bool get_new_subject(Tasks *entry, long index)
+{
+        if (entry == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> entry == NULL.");
+                return false;
+        }
+
+        if (!index_is_valid(index, entry))
+                return false;
+
+        show_prompt(entry, "new task: ");
+
+        char *subject = get_line(stdin);
+
+        if (subject == NULL)
+                return false;
+
+        bool ok = change_task(entry, index, subject);
+
+        free(subject);
+        subject = NULL;
+        return ok;
+}
+
 bool index_is_valid(long index, const Tasks *entry)
 {
         if (entry == NULL) {
-                WARNING("Bad parameter -> entry == NULL.");
+                FAIL(ERR_PARAM, "Bad parameter -> entry == NULL.");
                 return false;
         }
 
         return (index > 0) && (index <= tasks_size(entry));
 }
 
+bool get_list_name(Tasks *entry, char *name)
+{
+        if (entry == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> entry == NULL.");
+                return false;
+        }
+
+        if (name == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> name == NULL.");
+                return false;
+        }
+
+        show_prompt(entry, "list (empty for default): ");
+
+        if (!get_str(name, LIST_NAMESIZE, stdin))
+                return false;
+
+        if (!list_name_is_valid(name)) {
+                FAIL(ERR_FORMAT, "Invalid list name.");
+                return false;
+        }
+
+        return true;
+}
+
 bool get_str(char *str, int size, FILE *stream)
 {
         if (str == NULL) {
-                WARNING("Bad parameter -> str == NULL.");
+                FAIL(ERR_PARAM, "Bad parameter -> str == NULL.");
                 return false;
         }
 
         if (size < 2) {
-                WARNING("Bad parameter -> size < 2.");
+                FAIL(ERR_PARAM, "Bad parameter -> size < 2.");
                 return false;
         }
 
         if (stream == NULL) {
-                WARNING("Bad parameter -> stream == NULL.");
+                FAIL(ERR_PARAM, "Bad parameter -> stream == NULL.");
                 return false;
         }
 
@@ -169,39 +380,47 @@ bool get_str(char *str, int size, FILE *stream)
         return true;
 }
 
-bool get_date(Tasks *entry, char *str, int size)
+char *get_line(FILE *stream)
 {
-        if (entry == NULL) {
-                WARNING("Bad parameter -> entry == NULL.");
-                return false;
+        if (stream == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> stream == NULL.");
+                return NULL;
         }
 
-        if (str == NULL) {
-                WARNING("Bad parameter -> str == NULL.");
-                return false;
-        }
+        char *line = NULL;
+        size_t size = 0;
+        ssize_t len = getline(&line, &size, stream);
 
-        if (size < 2) {
-                WARNING("Bad parameter -> size < 2.");
-                return false;
+        if (len < 0) {
+                free(line);
+                return NULL;
         }
 
-        do {
-                show_tasks(entry);
-                printf("date: dd.mm.yyyy\b\b\b\b\b\b\b\b\b\b");
+        if (len > 0 && line[len - 1] == '\n')
+                line[len - 1] = '\0';
 
-                if (!get_str(str, size, stdin))
-                        continue;
+        return line;
+}
 
-        } while (!date_is_valid(str));
+bool get_date(Tasks *entry, Date *date)
+{
+        if (entry == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> entry == NULL.");
+                return false;
+        }
 
-        return true;
+        if (date == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> date == NULL.");
+                return false;
+        }
+
+        return ask_date(entry, "date: ", date);
 }
 
 bool stat_is_valid(char status)
 {
         if ((status != '+') && (status != '-')) {
-                WARNING("Invalid task status.");
+                err_set(ERR_FORMAT, "Invalid task status.");
                 return false;
         }
 
@@ -211,7 +430,7 @@ bool stat_is_valid(char status)
 bool file_is_empty(FILE *fp)
 {
         if (fp == NULL) {
-                WARNING("Bad parameter -> fp == NULL.");
+                FAIL(ERR_PARAM, "Bad parameter -> fp == NULL.");
                 return false;
         }
 
@@ -229,53 +448,74 @@ bool file_is_empty(FILE *fp)
 bool read_entry_from_file(FILE *fp, Tasks *entry)
 {
         if (fp == NULL) {
-                WARNING("Bad parameter -> fp == NULL.");
+                FAIL(ERR_PARAM, "Bad parameter -> fp == NULL.");
                 return false;
         }
 
         if (entry == NULL) {
-                WARNING("Bad parameter -> entry == NULL.");
+                FAIL(ERR_PARAM, "Bad parameter -> entry == NULL.");
                 return false;
         }
 
-        char line[LINESIZE] = { 0 };
-
-        while (get_str(line, LINESIZE, fp)) {
-
-                char date[DATESIZE] = { 0 };
-                char subject[SUBJSIZE] = { 0 };
-                bool status = false;
-
-                parse_line(line, date, &status, subject);
+        fseek(fp, 0L, SEEK_END);
+        long size = ftell(fp);
+        rewind(fp);
 
-                if (!add_task(entry, subject, status)) {
-                        WARNING("Failed to add task.");
-                        return false;
-                }
-        }
-        return true;
-}
+        char *text = size > 0 ? malloc(size) : NULL;
 
-bool write_entry_to_file(FILE *fp, Tasks *entry)
-{
-        if (fp == NULL) {
-                WARNING("Bad parameter -> fp == NULL.");
+        if (size > 0 && text == NULL) {
+                FAIL(ERR_NOMEM, "Out of memory.");
                 return false;
         }
 
-        if (entry == NULL) {
-                WARNING("Bad parameter -> entry == NULL.");
+        /* File is read at once and split into lines in batches. */
+        size_t text_len = size > 0 ? fread(text, 1, size, fp) : 0;
+
+        /*
+         * Every line takes at least SUBJOFFSET + 1 bytes of the file, and
+         * its subject with the terminator takes no more than the line.
+         */
+        if (!reserve_tasks(entry, text_len / (SUBJOFFSET + 1) + 1,
+                                text_len + 1)) {
+                WARNING("Failed to reserve memory for tasks.");
+                free(text);
                 return false;
         }
 
-        for (TasksElmt *el = tasks_head(entry); el != NULL; el = next_elmt(el)) {
-                Task *task = (Task *) el->data;
-                fprintf(fp, "%s %s %s\n",
-                                task->date, task->status ? "+" : "-",
-                                task->subject);
+        const char *pos = text;
+        const char *end = text + text_len;
+        LineBatch batch;
+        TaskView views[LINES_BATCH];
+        bool valid[LINES_BATCH];
+        bool ok = true;
+
+        while (ok && lines_split(&pos, end, &batch) > 0) {
+                lines_views(&batch, views, valid);
+
+                for (size_t i = 0; ok && i < batch.count; i++) {
+                        TaskView *view = &views[i];
+
+                        /* Damaged line is reported and kept as empty task. */
+                        if (!valid[i]) {
+                                parse_view(batch.starts[i], batch.lens[i],
+                                                view);
+                                ok = add_task(entry, "", UNDONE);
+                                continue;
+                        }
+
+                        ok = add_dated_task_len(entry, view->date,
+                                        view->subject, view->subj_len,
+                                        view->status);
+                }
         }
 
-        return true;
+        free(text);
+        text = NULL;
+
+        if (!ok)
+                WARNING("Failed to add task.");
+
+        return ok;
 }
 
 bool save_entry_to_history(FILE *fp)
@@ -285,269 +525,606 @@ bool save_entry_to_history(FILE *fp)
                 return false;
         }
 
-        FILE *history_fp = NULL;
-        char line[LINESIZE] = { 0 };
+        Manifest man;
 
-        history_fp = fopen(HISTORY, "a+");
-        if (history_fp == NULL) {
-                WARNING("Failed to create/open history.txt.");
+        if (!history_open(&man)) {
+                WARNING("Failed to open history.");
                 return false;
         }
 
-        while (fgets(line, LINESIZE, fp))
-                fputs(line, history_fp);
+        bool ok = history_append(&man, fp);
 
-        fclose(history_fp);
-        history_fp = NULL;
-        return true;
+        history_close(&man);
+        return ok;
 }
 
 bool show_history(void)
 {
-        FILE *history_fp = fopen(HISTORY, "a+");
+        HistoryQuery query = { 0, UINT32_MAX, QUERY_ANY_STATUS };
 
-        if (history_fp == NULL) {
-                WARNING("Failed to open history.txt.");
-                return false;
-        }
+        return list_history(&query);
+}
 
-        if (file_is_empty(history_fp)) {
-                fclose(history_fp);
-                history_fp = NULL;
-                return true;
+bool query_history(Tasks *entry)
+{
+        if (entry == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> entry == NULL.");
+                return false;
         }
 
-        clear_scr();
-        rewind(history_fp);
+        HistoryQuery query = { 0, 0, QUERY_ANY_STATUS };
 
-        char line[LINESIZE] = { 0 };
-        char prev_date[DATESIZE] = { 0 };
-        int  entries_sum = 0;
-        int  tasks_sum = 0;
+        ask_date(entry, "from: ", &query.from);
+        ask_date(entry, "to: ", &query.to);
 
-        while (fgets(line, LINESIZE, history_fp)) {
+        if (query.from > query.to) {
+                Date tmp = query.from;
 
-                char curr_date[DATESIZE] = { 0 };
-                char subject[SUBJSIZE] = { 0 };
-                bool status = false;
+                query.from = query.to;
+                query.to = tmp;
+        }
 
-                parse_line(line, curr_date, &status, subject);
-                if (!STRCMP(prev_date, ==, curr_date)) {
+        switch (get_opt(entry, QUERY_OPTIONS)) {
+                case 'x':
+                        query.status = DONE;
+                        break;
 
-                        ++entries_sum;
+                case 'u':
+                        query.status = UNDONE;
+                        break;
 
-                        if (entries_sum > 1)
-                                putchar('\n');
+                case 'd':
+                        return show_stats(query.from, query.to, PERIOD_DAY);
 
-                        tasks_sum = 0;
+                case 'w':
+                        return show_stats(query.from, query.to, PERIOD_WEEK);
 
-                        printf("%s\n", curr_date);
-                        SEPARATOR();
-                }
+                case 'm':
+                        return show_stats(query.from, query.to,
+                                        PERIOD_MONTH);
 
-                ++tasks_sum;
-                print_taskline(tasks_sum, status, subject);
-                strncpy(prev_date, curr_date, DATESIZE);
+                default:
+                        break;
         }
 
-        printf("\n---------------------\n");
-        printf("Total sum of entries: %d\n", entries_sum);
-        printf("\npress <Enter> to go back...");
-        clear_buf();
-
-        fclose(history_fp);
-        history_fp = NULL;
-        return true;
+        return list_history(&query);
 }
 
 bool search_history(Tasks *entry)
 {
         if (entry == NULL) {
-                WARNING("Bad parameter -> entry == NULL.");
+                FAIL(ERR_PARAM, "Bad parameter -> entry == NULL.");
                 return false;
         }
 
-        FILE *history_fp = fopen(HISTORY, "r");
-        if (history_fp == NULL) {
-                WARNING("Failed to open history.txt.");
+        Manifest man;
+
+        if (!history_open(&man)) {
+                WARNING("Failed to open history.");
                 return false;
         }
 
-        if (file_is_empty(history_fp)) {
-                fclose(history_fp);
-                history_fp = NULL;
+        bool empty = man.size == 0;
+
+        if (empty) {
+                history_close(&man);
                 return true;
         }
 
-        char search_date[DATESIZE] = { 0 };
-        get_date(entry, search_date, DATESIZE);
+        Date search_date = 0;
+        char date[DATESIZE] = { 0 };
 
-        clear_scr();
+        get_date(entry, &search_date);
+        date_to_str(search_date, date);
 
-        printf("%s\n", search_date);
-        SEPARATOR();
-
-        char line[LINESIZE] = { 0 };
+        /* Only the segment of the searched month is read. */
+        char *lines = NULL;
+        size_t lines_len = 0;
         long count = 0L;
+        bool ok = history_read_day(&man, search_date, &lines, &lines_len);
 
-        while (fgets(line, LINESIZE, history_fp)) {
-
-                char tmp_date[DATESIZE] = { 0 };
-                char subject[SUBJSIZE] = { 0 };
-                bool status = false;
+        history_close(&man);
 
-                parse_line(line, tmp_date, &status, subject);
+        if (!ok)
+                return false;
 
-                if (STRCMP(search_date, ==, tmp_date)) {
-                        Task *task = set_task(count + 1, search_date, status,
-                                        subject);
-                        if (task == NULL) {
-                                WARNING("Failed to setup task.");
-                                fclose(history_fp);
-                                history_fp = NULL;
-                                return false;
-                        }
+        frame_begin(FRAME_STREAM);
+        frame_printf("%s\n", date);
+        SEPARATOR();
 
-                        show_task(task);
-                        destroy_task(task);
-                        count++;
-                }
-
-                if (STRCMP(tmp_date, >, search_date))
-                        break;
-        }
+        search_lines(lines, lines_len, search_date, &count);
+        free(lines);
+        lines = NULL;
 
         if (count == 0)
-                printf(" no match\n");
+                frame_printf(" no match\n");
 
         SEPARATOR();
-        printf("Press <Enter> to go back...");
+        frame_printf("Press <Enter> to go back...");
+        frame_flush();
         clear_buf();
-
-        fclose(history_fp);
-        history_fp = NULL;
         return true;
-
 }
 
-bool erase_history(Tasks *entry)
+bool find_history(Tasks *entry)
 {
         if (entry == NULL) {
-                WARNING("Bad parameter -> entry == NULL.");
+                FAIL(ERR_PARAM, "Bad parameter -> entry == NULL.");
                 return false;
         }
 
-        FILE *history_fp = fopen(HISTORY, "r");
-        if (history_fp == NULL) {
-                WARNING("Failed to open history.txt.");
+        char query[LINESIZE] = { 0 };
+        uint64_t words[FIND_MAX_WORDS];
+        long nwords = 0;
+
+        show_prompt(entry, "find: ");
+
+        if (!get_str(query, sizeof(query), stdin))
                 return false;
+
+        const char *pos = query;
+        const char *end = query + strlen(query);
+        uint64_t word = 0;
+
+        while (nwords < FIND_MAX_WORDS && next_word(&pos, end, &word)) {
+                long i = 0;
+
+                while (i < nwords && words[i] != word)
+                        ++i;
+
+                if (i == nwords)
+                        words[nwords++] = word;
         }
 
-        if (file_is_empty(history_fp)) {
-                fclose(history_fp);
-                history_fp = NULL;
-                return true;
+        Manifest man;
+
+        if (nwords == 0 || !history_open(&man))
+                return nwords == 0;
+
+        Date *dates = NULL;
+        long ndates = find_dates(&man, words, nwords, &dates);
+
+        if (ndates < 0) {
+                history_close(&man);
+                return false;
         }
 
-        fclose(history_fp);
-        history_fp = NULL;
+        long total = 0L;
+        bool ok = true;
 
-        char choice = get_opt(entry, "yn");
-        if (choice == 'n')
-                return true;
+        frame_begin(FRAME_STREAM);
+
+        /* Index may point to dates where the words are in other tasks. */
+        for (long i = 0; ok && i < ndates; i++) {
+                char *lines = NULL;
+                size_t lines_len = 0;
+
+                ok = history_read_day(&man, dates[i], &lines, &lines_len);
+
+                if (ok)
+                        find_lines(lines, lines_len, dates[i], words, nwords,
+                                        &total);
+
+                free(lines);
+                lines = NULL;
+        }
+
+        free(dates);
+        dates = NULL;
+        history_close(&man);
 
-        history_fp = fopen(HISTORY, "w");
-        if (history_fp == NULL) {
-                WARNING("Failed to open history.txt.");
+        if (!ok)
                 return false;
+
+        if (total == 0) {
+                frame_printf("%s\n", query);
+                SEPARATOR();
+                frame_printf(" no match\n");
         }
 
-        fclose(history_fp);
-        history_fp = NULL;
+        SEPARATOR();
+        frame_printf("Press <Enter> to go back...");
+        frame_flush();
+        clear_buf();
         return true;
 }
 
+bool erase_history(Tasks *entry)
+{
+        if (entry == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> entry == NULL.");
+                return false;
+        }
+
+        Manifest man;
+
+        if (!history_open(&man)) {
+                WARNING("Failed to open history.");
+                return false;
+        }
+
+        bool ok = true;
+
+        if (man.size > 0 && get_opt(entry, "yn") == 'y')
+                ok = history_erase(&man);
+
+        history_close(&man);
+        return ok;
+}
+
 bool show_tasks(Tasks *entry)
+{
+        return show_prompt(entry, "");
+}
+
+bool show_prompt(Tasks *entry, const char *prompt)
 {
         if (entry == NULL) {
-                WARNING("Bad parameter -> entry == NULL.");
+                FAIL(ERR_PARAM, "Bad parameter -> entry == NULL.");
+                return false;
+        }
+
+        if (prompt == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> prompt == NULL.");
                 return false;
         }
 
-        clear_scr();
-        show_curr_date();
+        Date today = 0;
+        char date[DATESIZE] = { 0 };
+
+        get_curr_date(&today);
+        date_to_str(today, date);
+
+        frame_begin(FRAME_SCREEN);
+        if (list_paths()->name[0] != '\0')
+                frame_printf("%s [%s]\n", date, list_paths()->name);
+        else
+                frame_printf("%s\n", date);
         SEPARATOR();
         if (tasks_size(entry) == 0)
-                printf(" no tasks\n");
+                frame_printf(" no tasks\n");
         else
-                traverse_tasks(entry, show_task);
+                for (long i = 1; i <= tasks_size(entry); i++)
+                        show_task(entry, i);
         SEPARATOR();
+        frame_printf("%s", prompt);
 
-        return true;
+        return frame_flush();
 }
 
-void show_task(Task *task)
+void show_task(const Tasks *entry, long index)
 {
-        if (task == NULL) {
-                WARNING("Bad parameter -> task == NULL.");
+        if (entry == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> entry == NULL.");
                 return;
         }
 
-        print_taskline(task->index, task->status, task->subject);
+        print_taskline(index, task_status(entry, index),
+                        task_subject(entry, index),
+                        strlen(task_subject(entry, index)));
 }
 
-bool parse_line(char *line, char *date, bool *status, char *subject)
+bool parse_view(const char *line, size_t len, TaskView *view)
 {
         if (line == NULL) {
-                WARNING("Bad parameter -> line == NULL.");
+                FAIL(ERR_PARAM, "Bad parameter -> line == NULL.");
                 return false;
         }
 
-        if (date == NULL) {
-                WARNING("Bad parameter -> date == NULL.");
+        if (view == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> view == NULL.");
                 return false;
         }
 
-        if (status == NULL) {
-                WARNING("Bad parameter -> status == NULL.");
+        if (lines_view(line, len, view))
+                return true;
+
+        /* Line is checked again only to report what's wrong with it. */
+        if (len <= STATOFFSET)
+                return false;
+
+        if (!date_is_valid(line, &view->date)) {
+                FAIL(ERR_FORMAT, "Date is not valid.");
                 return false;
         }
 
-        if (subject == NULL) {
-                WARNING("Bad parameter -> subject == NULL.");
+        if (!stat_is_valid(line[STATOFFSET])) {
+                FAIL(ERR_FORMAT, "Task status isn't valid.");
                 return false;
         }
 
-        strncpy(date, line, DATEOFFSET);
-        date[DATEOFFSET] = '\0';
+        view->status = line[STATOFFSET] == '+';
+        view->subject = len > SUBJOFFSET ? line + SUBJOFFSET : line + len;
+        view->subj_len = len > SUBJOFFSET ? len - SUBJOFFSET : 0;
 
-        if (!date_is_valid(date)) {
-                WARNING("Date is not valid.");
+        return true;
+}
+
+static bool match_query(const TaskView *view, const void *arg)
+{
+        const HistoryQuery *query = arg;
+
+        return view->date >= query->from && view->date <= query->to &&
+                (query->status == QUERY_ANY_STATUS ||
+                 view->status == query->status);
+}
+
+static void show_line(const TaskView *view, void *arg)
+{
+        ListTotals *totals = arg;
+
+        if (totals->entries_sum == 0 && totals->tasks_sum == 0)
+                frame_begin(FRAME_STREAM);
+
+        if (totals->prev_date != view->date) {
+                char date[DATESIZE] = { 0 };
+
+                ++totals->entries_sum;
+
+                if (totals->entries_sum > 1)
+                        frame_write("\n", 1);
+
+                totals->tasks_sum = 0;
+
+                date_to_str(view->date, date);
+                frame_printf("%s\n", date);
+                SEPARATOR();
+        }
+
+        ++totals->tasks_sum;
+        ++totals->tasks;
+        totals->done += view->status;
+        print_taskline(totals->tasks_sum, view->status, view->subject,
+                        view->subj_len);
+        totals->prev_date = view->date;
+}
+
+static bool list_history(const HistoryQuery *query)
+{
+        Manifest man;
+
+        if (!history_open(&man)) {
+                WARNING("Failed to open history.");
                 return false;
         }
 
-        if(!stat_is_valid(line[STATOFFSET])) {
-                WARNING("Task status isn't valid.");
+        ListTotals totals = { 0, 0, 0, 0L, 0L };
+        bool ok = scan_history(&man, query->from, query->to, match_query,
+                        query, show_line, &totals);
+
+        history_close(&man);
+
+        if (!ok)
+                return false;
+
+        /* Empty history isn't shown at all, empty range says so. */
+        if (totals.entries_sum == 0 && query->from == 0)
+                return true;
+
+        if (totals.entries_sum == 0) {
+                frame_begin(FRAME_STREAM);
+                frame_printf(" no match\n");
+        }
+
+        frame_printf("\n---------------------\n");
+        frame_printf("Total sum of entries: %d\n", totals.entries_sum);
+        frame_printf("Total sum of tasks: %ld, done: %ld (%ld%%)\n",
+                        totals.tasks, totals.done, totals.tasks ?
+                        totals.done * 100 / totals.tasks : 0L);
+        frame_printf("\npress <Enter> to go back...");
+        frame_flush();
+        clear_buf();
+        return true;
+}
+
+static bool show_stats(Date from, Date to, Period period)
+{
+        Manifest man;
+
+        if (!history_open(&man)) {
+                WARNING("Failed to open history.");
                 return false;
         }
 
-        *status = line[STATOFFSET] == '+';
+        PeriodStats *rows = NULL;
+        long nrows = summary_stats(&man, from, to, period, &rows);
+
+        history_close(&man);
+
+        if (nrows < 0)
+                return false;
+
+        static const char *titles[] = { "day", "week from", "month" };
+        char from_str[DATESIZE] = { 0 };
+        char to_str[DATESIZE] = { 0 };
+        Stats sum = { 0, 0 };
 
-        strncpy(subject, line + SUBJOFFSET, SUBJSIZE);
-        char *new_line = strchr(subject, '\n');
+        date_to_str(from, from_str);
+        date_to_str(to, to_str);
 
-        if (new_line)
-                *new_line = '\0';
+        frame_begin(FRAME_STREAM);
+        frame_printf("%s - %s\n", from_str, to_str);
+        SEPARATOR();
+        frame_printf(" %-10s %11s %5s\n", titles[period], "done/total",
+                        "rate");
+
+        for (long i = 0; i < nrows; i++) {
+                char key[DATESIZE] = { 0 };
+
+                /* Months are shown without the day. */
+                date_to_str(rows[i].key, key);
+                frame_printf(" %-10s %5" PRIu32 "/%-5" PRIu32 " %4" PRIu32
+                                "%%\n", period == PERIOD_MONTH ? key + 3 :
+                                key, rows[i].stats.done,
+                                rows[i].stats.total, rows[i].stats.done *
+                                100 / rows[i].stats.total);
+                sum.done += rows[i].stats.done;
+                sum.total += rows[i].stats.total;
+        }
 
+        if (nrows == 0)
+                frame_printf(" no match\n");
+
+        SEPARATOR();
+        frame_printf(" %-10s %5" PRIu32 "/%-5" PRIu32 " %4" PRIu32 "%%\n",
+                        "total", sum.done, sum.total, sum.total ?
+                        sum.done * 100 / sum.total : 0);
+        frame_printf("Press <Enter> to go back...");
+        frame_flush();
+        clear_buf();
+
+        free(rows);
+        rows = NULL;
         return true;
 }
 
-static void print_taskline(long index, bool status, char *subject)
+static bool ask_date(Tasks *entry, const char *prompt, Date *date)
+{
+        char str[DATESIZE] = { 0 };
+        char line[LINESIZE] = { 0 };
+
+        snprintf(line, sizeof(line), "%sdd.mm.yyyy\b\b\b\b\b\b\b\b\b\b",
+                        prompt);
+
+        do {
+                show_prompt(entry, line);
+
+                if (!get_str(str, DATESIZE, stdin))
+                        continue;
+
+        } while (!date_is_valid(str, date));
+
+        return true;
+}
+
+static void search_lines(const char *data, size_t size, Date key,
+                long *count)
+{
+        const char *pos = data;
+        const char *end = data + size;
+        const char *line = NULL;
+        size_t len = 0;
+
+        while (next_line(&pos, end, &line, &len)) {
+                TaskView view;
+
+                if (!parse_view(line, len, &view) || view.date != key)
+                        continue;
+
+                print_taskline(++*count, view.status, view.subject,
+                                view.subj_len);
+        }
+}
+
+static void find_lines(const char *data, size_t size, Date key,
+                const uint64_t *words, long nwords, long *total)
+{
+        const char *pos = data;
+        const char *end = data + size;
+        const char *line = NULL;
+        size_t len = 0;
+        long count = 0L;
+
+        while (next_line(&pos, end, &line, &len)) {
+                TaskView view;
+
+                if (!parse_view(line, len, &view) || view.date != key)
+                        continue;
+
+                /* Every word of the query must be in the subject. */
+                bool found[FIND_MAX_WORDS] = { false };
+                long nfound = 0;
+                const char *word_pos = view.subject;
+                uint64_t word = 0;
+
+                while (nfound < nwords && next_word(&word_pos, view.subject +
+                                        view.subj_len, &word))
+                        for (long i = 0; i < nwords; i++)
+                                if (!found[i] && words[i] == word) {
+                                        found[i] = true;
+                                        ++nfound;
+                                }
+
+                if (nfound < nwords)
+                        continue;
+
+                if (count == 0) {
+                        char date[DATESIZE] = { 0 };
+
+                        if (*total > 0)
+                                frame_write("\n", 1);
+
+                        date_to_str(key, date);
+                        frame_printf("%s\n", date);
+                        SEPARATOR();
+                        ++*total;
+                }
+
+                print_taskline(++count, view.status, view.subject,
+                                view.subj_len);
+        }
+}
+
+static long find_dates(const Manifest *man, const uint64_t *words,
+                long nwords, Date **dates)
+{
+        long ndates = windex_find(man, words[0], dates);
+
+        if (ndates <= 0)
+                return ndates;
+
+        qsort(*dates, ndates, sizeof(Date), cmp_dates_desc);
+
+        /* Keep unique dates which every other word has as well. */
+        for (long w = 1; w < nwords && ndates > 0; w++) {
+                Date *other = NULL;
+                long nother = windex_find(man, words[w], &other);
+
+                if (nother < 0) {
+                        free(*dates);
+                        *dates = NULL;
+                        return -1;
+                }
+
+                qsort(other, nother, sizeof(Date), cmp_dates_desc);
+
+                long kept = 0;
+
+                for (long i = 0; i < ndates; i++)
+                        if (bsearch(&(*dates)[i], other, nother, sizeof(Date),
+                                                cmp_dates_desc) != NULL)
+                                (*dates)[kept++] = (*dates)[i];
+
+                ndates = kept;
+                free(other);
+                other = NULL;
+        }
+
+        long unique = 0;
+
+        for (long i = 0; i < ndates; i++)
+                if (unique == 0 || (*dates)[unique - 1] != (*dates)[i])
+                        (*dates)[unique++] = (*dates)[i];
+
+        return unique;
+}
+
+static int cmp_dates_desc(const void *a, const void *b)
+{
+        Date da = *(const Date *) a;
+        Date db = *(const Date *) b;
+
+        return da == db ? 0 : da > db ? -1 : 1;
+}
+
+static void print_taskline(long index, bool status, const char *subject,
+                int len)
 {
         if (subject == NULL) {
-                WARNING("Bad parameter -> subject == NULL.");
+                FAIL(ERR_PARAM, "Bad parameter -> subject == NULL.");
                 return;
         }
 
-        printf(" %ld [%c] %s\n", index, status ? 'X' : ' ', subject);
+        frame_printf(" %ld [%c] %.*s\n", index, status ? 'X' : ' ', len,
+                        subject);
 }
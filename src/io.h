@@ -12,25 +12,59 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "archive.h"
 #include "date.h"
 #include "error.h"
+#include "frame.h"
+#include "hindex.h"
+#include "history.h"
+#include "lines.h"
+#include "mapfile.h"
+#include "scan.h"
+#include "summary.h"
 #include "tasks.h"
 #include "types.h"
+#include "windex.h"
 
 /**
  * Constant with available options for an empty list.
  */
-#define OPTIONS1     "aehlqs"
+#define OPTIONS1     "aefhlLqrs"
 
 /**
  * Constant with available options for a list which is not empty.
  */
-#define OPTIONS2     "acdDehlqsuUxX"
+#define OPTIONS2     "acdDefhlLqrsuUxX"
 
 /**
- * Macro for drawing separator.
+ * Constant with options of a history range query: all, done or undone
+ * tasks, or statistics per day, week or month.
  */
-#define SEPARATOR()  printf("----------\n")
+#define QUERY_OPTIONS "axudwm"
+
+/**
+ * Status filter of a history query which lets tasks of any status through.
+ */
+#define QUERY_ANY_STATUS -1
+
+/**
+ * Maximum number of words in a history find query.
+ */
+#define FIND_MAX_WORDS 8
+
+/**
+ * Macro for drawing separator into the current frame.
+ */
+#define SEPARATOR()  frame_printf("----------\n")
+
+/**
+ * @brief Type definition for the history query.
+ */
+typedef struct HistoryQuery_tag {
+        Date from; ///< First date of the range.
+        Date to; ///< Last date of the range.
+        int  status; ///< DONE, UNDONE or QUERY_ANY_STATUS.
+} HistoryQuery;
 
 /**
  * @brief Uses ASCII sequences to clear console screen and place cursor at
@@ -48,6 +82,18 @@ void clear_buf(void);
  */
 void show_opts(void);
 
+/**
+ * @brief Shows reports made since the previous call.
+ *
+ * Takes reports from the error ring and, if there are any, prints them
+ * followed by @p prompt and waits for <Enter>. Reporting itself never
+ * waits, so this is the only place where the user is asked to read them.
+ *
+ * @param[in] prompt Read-only string with the prompt.
+ * @return True if there were reports, or false otherwise.
+ */
+bool show_reports(const char *prompt);
+
 /**
  * @brief Returns set of available options.
  *
@@ -91,11 +137,10 @@ bool opt_is_valid(const char *opts, char ch);
 /**
  * @brief Gets number of type long.
  *
- * Takes string as an input and tries to convert it into long.
- * Length of the string is limited to 3 characters (including '\0')
- * because of the limit of tasks in one entry, which is 99.
+ * Takes a line of any length as an input and tries to convert it into
+ * long. The whole line must be a non-negative number.
  *
- * return long from 1 to 99 on success, or -1 otherwise.
+ * @return Non-negative long on success, or -1 otherwise.
  */
 long get_long(void);
 
@@ -110,6 +155,42 @@ long get_long(void);
  */
 long get_index(Tasks *entry);
 
+/**
+ * @brief Asks for a new task.
+ *
+ * Prompts the user for a task description and appends an undone task
+ * with it to the list specified by @p entry.
+ *
+ * @param[in,out] entry Pointer to the task list.
+ * @return True on success, or false otherwise.
+ */
+bool get_task(Tasks *entry);
+
+/**
+ * @brief Asks for a new task description.
+ *
+ * Prompts the user for a new description of the task with index
+ * @p index in the list specified by @p entry.
+ *
+ * @param[in,out] entry Pointer to the task list.
+ * @param[in] index Long int with the task index.
+ * @return True on success, or false otherwise.
+ */
+bool get_new_subject(Tasks *entry, long index);
+
+/**
+ * @brief Asks for a list name.
+ *
+ * Prompts the user for the name of the list to switch to. Empty name
+ * stands for the default list.
+ *
+ * @param[in] entry Pointer to the task list shown above the prompt.
+ * @param[in,out] name Buffer of LIST_NAMESIZE characters, where the name
+ *                is to be stored.
+ * @return True if a valid name was given, or false otherwise.
+ */
+bool get_list_name(Tasks *entry, char *name);
+
 /**
  * @brief Checks if task index is valid.
  *
@@ -135,34 +216,42 @@ bool index_is_valid(long index, const Tasks *entry);
 bool get_str(char *str, int size, FILE *stream);
 
 /**
- * @brief Gets string with date.
+ * @brief Gets line of any length.
+ *
+ * Reads a line from @p stream into a newly allocated string without the
+ * line terminator. It's responsibility of the caller to free the string.
+ *
+ * @param stream File pointer with stream.
+ * @return Pointer to the string on success, or NULL at the end of input.
+ */
+char *get_line(FILE *stream);
+
+/**
+ * @brief Gets date.
  *
  * Asks for a date string until it's valid and saves it to a variable
- * specified by @p str. @p str must not be NULL. It's responsibility
- * of the caller to provide memory for it. Date string size is specified
- * by @p size.
+ * specified by @p date. @p date must not be NULL. It's responsibility
+ * of the caller to provide memory for it.
  *
  * @param[in] entry Pointer to the task list.
- * @param[in,out] str String, where the date will be stored.
- * @param[in] size Size of the string, where the date will be stored.
+ * @param[in,out] date Pointer, where the date will be stored.
  * @return True on success, or false otherwise.
  */
-bool get_date(Tasks *entry, char *str, int size);
+bool get_date(Tasks *entry, Date *date);
 
 /**
- * @brief Parses a line from a file with tasks.
+ * @brief Parses a line from a mapped file with tasks.
  *
- * Takes string read from file with tasks and places read values into
- * the variables they belong to. All parameters must not be NULL.
- * It's responsibility of the caller to privide memory for them.
+ * Doesn't copy anything: the view specified by @p view points straight
+ * into @p line, which is not required to be terminated. The line must
+ * outlive the view.
  *
- * @param[in] line String, which is to be parsed.
- * @param[in,out] date String where the date is to be stored.
- * @param[in,out] status Bool variable, where task status is to be stored.
- * @param[in,out] subject String where task subject string is to be stored.
+ * @param[in] line Read-only line, which is to be parsed.
+ * @param[in] len Length of the line.
+ * @param[in,out] view Pointer to the view, which is to be set.
  * @return True on success, or false otherwise.
  */
-bool parse_line(char *line, char *date, bool *status, char *subject);
+bool parse_view(const char *line, size_t len, TaskView *view);
 
 /**
  * @brief Checks if task status is valid.
@@ -195,24 +284,12 @@ bool file_is_empty(FILE *fp);
  */
 bool read_entry_from_file(FILE *fp, Tasks *entry);
 
-/**
- * @brief Writes entry to file.
- *
- * Traverses task list specified by @p entry and writes all the
- * tasks into file specified by @p fp.
- *
- * @param[in,out] fp File pointer to a file where entry is to be written.
- * @param[in] entry Pointer to the task list from where entry is to be taken.
- * @return True on success, or false otherwise.
- */
-bool write_entry_to_file(FILE *fp, Tasks *entry);
-
 /**
  * @brief Saves entry to history file.
  *
- * Opens file specified by @p fp with entry and appends it to
- * history.txt. If history.txt is not existing, it will be created.
- * 
+ * Opens file specified by @p fp with entry and appends it to the
+ * history segment of its month. Segment is created if it's not existing.
+ *
  * @param[in] fp File pointer to the file with entry is to be copied.
  * @return True on success, or False otherwise.
  */
@@ -221,28 +298,57 @@ bool save_entry_to_history(FILE *fp);
 /**
  * @brief Prints task history.
  *
- * Opens history.txt, specified by @p fp, reads its content,
- * and prints it in convenient way.
+ * Maps history segments into memory one by one, walks their content
+ * without copying, and prints it in convenient way.
  *
  * @return True on success, or false otherwise.
  */
 bool show_history(void);
 
+/**
+ * @brief Queries history by date range.
+ *
+ * Asks caller for a range of dates and a query option. Tasks of the range,
+ * optionally only done or undone ones, are listed in one streaming pass
+ * over the segments of the range, which decompresses only the archive
+ * blocks the range overlaps. Statistics per day, week or month are summed
+ * from the segment summaries without reading history lines.
+ *
+ * @param[in] entry Pointer to the task list.
+ * @return True on success, or false otherwise.
+ */
+bool query_history(Tasks *entry);
+
 /**
  * @brief Searches history by date.
  *
  * Asks caller for a date and, if it's valid and there is an
- * entry in the history with this date, prints it.
+ * entry in the history with this date, prints it. Only the segment of
+ * the date's month is opened, and the entry is found through its index,
+ * so only its own lines are read, see history_read_day().
  *
  * @param[in] entry Pointer to the task list.
  * @return True on success, or false otherwise.
  */
 bool search_history(Tasks *entry);
 
+/**
+ * @brief Finds history entries by words.
+ *
+ * Asks caller for words and prints tasks from history which have all of
+ * them in the subject, newest entries first. Dates are looked up in the
+ * word index, so only the entries which may match are read.
+ *
+ * @param[in] entry Pointer to the task list.
+ * @return True on success, or false otherwise.
+ */
+bool find_history(Tasks *entry);
+
 /**
  * @brief Erases history.
  *
- * Opens history file history.txt and erases its content.
+ * Asks for confirmation and removes all history segments together with
+ * their indexes.
  *
  * @param[in] entry Pointer to the task list.
  * @return True on success, or false otherwise.
@@ -252,20 +358,36 @@ bool erase_history(Tasks *entry);
 /**
  * @brief Prints entry tasks.
  *
- * Traverses task list and prints found tasks.
+ * Traverses task list and prints found tasks. Same as show_prompt() with
+ * an empty prompt.
  *
  * @param[in] entry Pointer to the task list.
  * @return True on success, or false otherwise.
  */
 bool show_tasks(Tasks *entry);
 
+/**
+ * @brief Prints entry tasks followed by a prompt.
+ *
+ * Renders the current date, the task list specified by @p entry and the
+ * prompt specified by @p prompt as one screen frame and emits it with
+ * a single write, sending only what changed since the previous screen.
+ *
+ * @param[in] entry Pointer to the task list.
+ * @param[in] prompt Read-only string with the prompt, may be empty.
+ * @return True on success, or false otherwise.
+ */
+bool show_prompt(Tasks *entry, const char *prompt);
+
 /**
  * @brief Prints task.
  *
- * Prints single task specified by @p task.
+ * Prints single task with index @p index from the list specified by
+ * @p entry. Index must be valid.
  *
- * @param[in] task Pointer to the task.
+ * @param[in] entry Pointer to the read-only task list.
+ * @param[in] index Long int with the task index.
  */
-void show_task(Task *task);
+void show_task(const Tasks *entry, long index);
 
 #endif
@@ -0,0 +1,262 @@
+/**
+ * @file journal.c
+ * @brief Function definitions for the operation journal of the entry.
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "batch.h"
+#include "error.h"
+#include "io.h"
+#include "journal.h"
+#include "mapfile.h"
+#include "store.h"
+#include "tasks.h"
+
+/** Size of the buffer most records fit in. */
+#define JOURNAL_RECSIZE (LINESIZE * 2)
+
+/**
+ * @brief Applies one journal record to the entry.
+ * @param[in,out] entry Pointer to the task list.
+ * @param[in] line Read-only record without the line terminator.
+ * @return True on success, or false otherwise.
+ */
+static bool replay_record(Tasks *entry, const char *line);
+
+/**
+ * @brief Replays journal records over the entry file.
+ * @param[in] fp Pointer to the journal positioned after the header.
+ * @param[in] entry_path Read-only string with the entry file name.
+ * @return True on success, or false otherwise.
+ */
+static bool replay_journal(FILE *fp, const char *entry_path);
+
+bool journal_recover(const char *path, const char *entry_path)
+{
+        if (path == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> path == NULL.");
+                return false;
+        }
+
+        if (entry_path == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> entry_path == NULL.");
+                return false;
+        }
+
+        FILE *fp = fopen(path, "r");
+
+        if (fp == NULL)
+                return errno == ENOENT;
+
+        char *line = NULL;
+        size_t size = 0;
+        bool ok = true;
+
+        /* Journal is replayed only over the entry it was started for. */
+        if (getline(&line, &size, fp) > 2 && line[0] == '@') {
+                uint64_t stored = strtoull(line + 2, NULL, 16);
+                MapFile map = { NULL, 0 };
+                bool mapped = map_file(entry_path, &map);
+
+                if ((mapped || errno == ENOENT) &&
+                                store_hash(map.data, map.size) == stored)
+                        ok = replay_journal(fp, entry_path);
+
+                if (mapped)
+                        unmap_file(&map);
+        }
+
+        free(line);
+        line = NULL;
+        fclose(fp);
+        fp = NULL;
+
+        if (ok && truncate(path, 0L) < 0) {
+                FAIL(ERR_IO, "Failed to empty journal.");
+                ok = false;
+        }
+
+        return ok;
+}
+
+bool journal_open(Journal *journal, const char *path,
+                const char *entry_path)
+{
+        if (journal == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> journal == NULL.");
+                return false;
+        }
+
+        journal->fd = open(path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+        journal->records = 0;
+        journal->path = path;
+        journal->entry_path = entry_path;
+
+        if (journal->fd < 0) {
+                FAIL(ERR_IO, "Failed to open journal.");
+                return false;
+        }
+
+        return true;
+}
+
+bool journal_record(Journal *journal, const Tasks *entry,
+                const char *format, ...)
+{
+        if (journal == NULL || journal->fd < 0)
+                return true;
+
+        char buf[JOURNAL_RECSIZE];
+        char *rec = buf;
+        va_list args;
+
+        va_start(args, format);
+        int len = vsnprintf(buf, sizeof(buf) - 1, format, args);
+        va_end(args);
+
+        if (len < 0) {
+                WARNING("Failed to format journal record.");
+                return false;
+        }
+
+        /* Long subjects don't fit the stack buffer. */
+        if ((size_t) len >= sizeof(buf) - 1) {
+                rec = malloc(len + 2);
+
+                if (rec == NULL) {
+                        FAIL(ERR_NOMEM, "Out of memory.");
+                        return false;
+                }
+
+                va_start(args, format);
+                vsnprintf(rec, len + 1, format, args);
+                va_end(args);
+        }
+
+        rec[len++] = '\n';
+
+        bool ok = store_write(journal->fd, rec, len);
+
+        if (rec != buf)
+                free(rec);
+        rec = NULL;
+
+        if (!ok) {
+                FAIL(ERR_IO, "Failed to write journal record.");
+                return false;
+        }
+
+        if (++journal->records >= JOURNAL_COMPACT_RECORDS)
+                return journal_compact(journal, entry);
+
+        return true;
+}
+
+bool journal_compact(Journal *journal, const Tasks *entry)
+{
+        if (journal == NULL || journal->fd < 0) {
+                FAIL(ERR_PARAM, "Bad parameter -> journal isn't open.");
+                return false;
+        }
+
+        size_t len = 0;
+        char *buf = serialize_entry(entry,
+                        entry_format(journal->entry_path), &len);
+
+        if (buf == NULL)
+                return false;
+
+        bool ok = store_file(journal->entry_path, buf, len);
+        uint64_t hash = store_hash(buf, len);
+
+        free(buf);
+        buf = NULL;
+
+        if (!ok)
+                return false;
+
+        /*
+         * Old records are already in the entry file. If the program dies
+         * before the new header is written, the old one doesn't match the
+         * entry file any more and the records are not replayed twice.
+         */
+        if (ftruncate(journal->fd, 0) < 0) {
+                FAIL(ERR_IO, "Failed to empty journal.");
+                return false;
+        }
+
+        char header[JOURNAL_RECSIZE];
+        int header_len = snprintf(header, sizeof(header), "@ %016" PRIx64
+                        "\n", hash);
+
+        if (!store_write(journal->fd, header, header_len)) {
+                FAIL(ERR_IO, "Failed to write journal header.");
+                return false;
+        }
+
+        journal->records = 0;
+        return true;
+}
+
+void journal_close(Journal *journal)
+{
+        if (journal == NULL || journal->fd < 0)
+                return;
+
+        close(journal->fd);
+        journal->fd = -1;
+}
+
+static bool replay_record(Tasks *entry, const char *line)
+{
+        if (line[0] != 'a' || line[1] != ' ')
+                return apply_op(entry, line);
+
+        TaskView view = { 0, NULL, 0, false };
+
+        return parse_view(line + 2, strlen(line + 2), &view) &&
+                add_dated_task_len(entry, view.date, view.subject,
+                                view.subj_len, view.status);
+}
+
+static bool replay_journal(FILE *fp, const char *entry_path)
+{
+        Tasks entry;
+        init_tasks(&entry);
+
+        EntryFormat format = entry_format(entry_path);
+        bool ok = read_entry(entry_path, &entry);
+
+        char *line = NULL;
+        size_t size = 0;
+        ssize_t len = 0;
+
+        while (ok && (len = getline(&line, &size, fp)) != -1) {
+                /* Record torn by a crash is the last one and is dropped. */
+                if (line[len - 1] != '\n')
+                        break;
+
+                line[len - 1] = '\0';
+
+                if (!replay_record(&entry, line))
+                        FAIL(ERR_FORMAT, "Skipped bad journal record.");
+        }
+
+        free(line);
+        line = NULL;
+
+        if (ok)
+                ok = store_entry(entry_path, &entry, format);
+
+        destroy_tasks(&entry);
+        return ok;
+}
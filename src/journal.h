@@ -0,0 +1,106 @@
+/**
+ * @file journal.h
+ * @brief Interface for the operation journal of the entry.
+ *
+ * Every change of the entry is appended to the journal as one short text
+ * record, so an edit costs a few bytes written instead of the whole list.
+ * Records use the syntax of batch operations, except that an added task
+ * is recorded as "a " followed by its last_entry.txt line, so its date and
+ * status survive the replay.
+ *
+ * The first line of the journal is "@ " followed by the hash of
+ * last_entry.txt the records apply to. Journal, which doesn't match
+ * last_entry.txt, is stale and is discarded instead of being replayed.
+ *
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "types.h"
+
+/** Number of records after which the journal is compacted. */
+#define JOURNAL_COMPACT_RECORDS 256
+
+/**
+ * @brief Type definition for the open journal.
+ */
+typedef struct Journal_tag {
+        int        fd; ///< Descriptor of the journal file, or -1.
+        long       records; ///< Number of records since the last compaction.
+        const char *path; ///< Name of the journal file.
+        const char *entry_path; ///< Name of the file with the entry.
+} Journal;
+
+/**
+ * @brief Replays leftover journal.
+ *
+ * If the journal specified by @p path belongs to the file specified by
+ * @p entry_path, applies its records to the entry stored there and saves
+ * the result. Journal is emptied afterwards in any case. Must be called
+ * before the entry is loaded.
+ *
+ * @param[in] path Read-only string with the journal file name.
+ * @param[in] entry_path Read-only string with the entry file name.
+ * @return True on success, or false otherwise.
+ */
+bool journal_recover(const char *path, const char *entry_path);
+
+/**
+ * @brief Opens journal.
+ *
+ * Opens the journal file specified by @p path for appending. Records are
+ * applied to the entry stored in the file specified by @p entry_path.
+ * Journal must be compacted with journal_compact() before first record.
+ *
+ * @param[in,out] journal Pointer to the journal, which is to be set.
+ * @param[in] path Read-only string with the journal file name.
+ * @param[in] entry_path Read-only string with the entry file name.
+ * @return True on success, or false otherwise.
+ */
+bool journal_open(Journal *journal, const char *path,
+                const char *entry_path);
+
+/**
+ * @brief Appends record to the journal.
+ *
+ * Formats record from @p format and appends it to the journal with one
+ * write(). Once the journal holds JOURNAL_COMPACT_RECORDS records, it is
+ * compacted with the list specified by @p entry. NULL @p journal is
+ * allowed and means journaling is off.
+ *
+ * @param[in,out] journal Pointer to the journal, or NULL.
+ * @param[in] entry Pointer to the read-only task list after the change.
+ * @param[in] format Read-only printf-like format string.
+ * @return True on success, or false otherwise.
+ */
+bool journal_record(Journal *journal, const Tasks *entry,
+                const char *format, ...);
+
+/**
+ * @brief Compacts journal.
+ *
+ * Atomically saves the list specified by @p entry into the entry file and
+ * starts the journal over.
+ *
+ * @param[in,out] journal Pointer to the journal.
+ * @param[in] entry Pointer to the read-only task list.
+ * @return True on success, or false otherwise.
+ */
+bool journal_compact(Journal *journal, const Tasks *entry);
+
+/**
+ * @brief Closes journal.
+ *
+ * @param[in,out] journal Pointer to the journal.
+ * @return Nothing.
+ */
+void journal_close(Journal *journal);
+
+#endif
@@ -0,0 +1,392 @@
+/**
+ * @file lines.c
+ * @brief Function definitions for the vectorized task line tokenizer.
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "date.h"
+#include "lines.h"
+
+#if defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__))
+#define LINES_X86 1
+#include <immintrin.h>
+#endif
+
+/** Bits of the digit columns of "dd.mm.yyyy". */
+#define LAYOUT_DIGITS 0x03db
+
+/** Bits of the dot columns of "dd.mm.yyyy". */
+#define LAYOUT_DOTS   0x0024
+
+/** Bit of the status column. */
+#define LAYOUT_STATUS (1 << STATOFFSET)
+
+/** Bits of all the checked columns of a task line. */
+#define LAYOUT_ALL    (LAYOUT_DIGITS | LAYOUT_DOTS | LAYOUT_STATUS)
+
+/** Bits of the columns @p m for two lines in the lanes of one vector. */
+#define LAYOUT_LANES(m) ((uint32_t) (m) | (uint32_t) (m) << 16)
+
+/**
+ * @brief Type definition for the line splitting routine.
+ */
+typedef size_t (*SplitFn)(const char **pos, const char *end,
+                LineBatch *batch);
+
+/**
+ * @brief Splits lines with memchr().
+ */
+static size_t split_scalar(const char **pos, const char *end,
+                LineBatch *batch);
+
+/**
+ * @brief Splits lines from @p start, scanning for newlines from @p from.
+ *
+ * Finishes a batch started by a vector routine, which has already checked
+ * that there is no newline between @p start and @p from.
+ */
+static size_t split_tail(const char *start, const char *from,
+                const char **pos, const char *end, LineBatch *batch);
+
+#ifdef LINES_X86
+/**
+ * @brief Splits lines 16 bytes at a time.
+ */
+static size_t split_sse2(const char **pos, const char *end,
+                LineBatch *batch);
+
+/**
+ * @brief Splits lines 32 bytes at a time.
+ */
+__attribute__((target("avx2")))
+static size_t split_avx2(const char **pos, const char *end,
+                LineBatch *batch);
+#endif
+
+/**
+ * @brief Type definition for the batch parsing routine.
+ */
+typedef size_t (*ViewsFn)(const LineBatch *batch, TaskView *views,
+                bool *valid);
+
+/**
+ * @brief Parses lines of the batch one at a time.
+ */
+static size_t views_single(const LineBatch *batch, TaskView *views,
+                bool *valid);
+
+#ifdef LINES_X86
+/**
+ * @brief Parses lines of the batch two at a time.
+ */
+__attribute__((target("avx2")))
+static size_t views_avx2(const LineBatch *batch, TaskView *views,
+                bool *valid);
+#endif
+
+/**
+ * @brief Checks the layout of "dd.mm.yyyy S" byte by byte.
+ */
+static bool layout_scalar(const char *line);
+
+/**
+ * @brief Combines the date digits of a line with valid layout into a view.
+ */
+static bool make_view(const char *line, size_t len, TaskView *view);
+
+/**
+ * @brief Picks the implementation, once per process.
+ */
+static void pick_isa(void);
+
+/** Implementation in use. */
+static SplitFn split_impl = split_scalar;
+
+/** Batch parsing implementation in use. */
+static ViewsFn views_impl = views_single;
+
+/** Name of the implementation in use. */
+static const char *isa_name = "scalar";
+
+/** Guards the choice of the implementation. */
+static pthread_once_t isa_once = PTHREAD_ONCE_INIT;
+
+/**
+ * @brief Adds line to the batch.
+ */
+#define BATCH_ADD(batch, start, stop) \
+{ \
+        (batch)->starts[(batch)->count] = (start); \
+        (batch)->lens[(batch)->count] = (stop) - (start); \
+        ++(batch)->count; \
+}
+
+size_t lines_split(const char **pos, const char *end, LineBatch *batch)
+{
+        pthread_once(&isa_once, pick_isa);
+        batch->count = 0;
+
+        if (*pos == NULL || *pos >= end)
+                return 0;
+
+        return split_impl(pos, end, batch);
+}
+
+bool lines_view(const char *line, size_t len, TaskView *view)
+{
+        if (len <= STATOFFSET)
+                return false;
+
+#ifdef LINES_X86
+        if (len >= 16) {
+                /* Digits and dots of the date and the status at once. */
+                const __m128i dots = _mm_setr_epi8(0, 0, '.', 0, 0, '.',
+                                0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+                __m128i v = _mm_loadu_si128((const __m128i *) line);
+                __m128i digits = _mm_sub_epi8(v, _mm_set1_epi8('0'));
+                __m128i is_digit = _mm_cmpeq_epi8(_mm_max_epu8(digits,
+                                        _mm_set1_epi8(9)), _mm_set1_epi8(9));
+                __m128i is_dot = _mm_cmpeq_epi8(v, dots);
+                __m128i is_stat = _mm_or_si128(
+                                _mm_cmpeq_epi8(v, _mm_set1_epi8('+')),
+                                _mm_cmpeq_epi8(v, _mm_set1_epi8('-')));
+                unsigned mask = (_mm_movemask_epi8(is_digit) & LAYOUT_DIGITS) |
+                        (_mm_movemask_epi8(is_dot) & LAYOUT_DOTS) |
+                        (_mm_movemask_epi8(is_stat) & LAYOUT_STATUS);
+
+                if (mask != LAYOUT_ALL)
+                        return false;
+        } else
+#endif
+        if (!layout_scalar(line))
+                return false;
+
+        return make_view(line, len, view);
+}
+
+size_t lines_views(const LineBatch *batch, TaskView *views, bool *valid)
+{
+        pthread_once(&isa_once, pick_isa);
+        return views_impl(batch, views, valid);
+}
+
+const char *lines_isa(void)
+{
+        pthread_once(&isa_once, pick_isa);
+        return isa_name;
+}
+
+static size_t views_single(const LineBatch *batch, TaskView *views,
+                bool *valid)
+{
+        size_t count = 0;
+
+        for (size_t i = 0; i < batch->count; i++) {
+                valid[i] = lines_view(batch->starts[i], batch->lens[i],
+                                &views[i]);
+                count += valid[i];
+        }
+
+        return count;
+}
+
+#ifdef LINES_X86
+__attribute__((target("avx2")))
+static size_t views_avx2(const LineBatch *batch, TaskView *views,
+                bool *valid)
+{
+        /* Prefixes of two lines share one vector, one per 128-bit lane. */
+        const __m256i dots = _mm256_setr_epi8(0, 0, '.', 0, 0, '.', 0, 0,
+                        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, '.', 0, 0, '.', 0, 0,
+                        0, 0, 0, 0, 0, 0, 0, 0);
+        const __m256i nine = _mm256_set1_epi8(9);
+        size_t count = 0;
+        size_t i = 0;
+
+        while (i < batch->count) {
+                /* Short lines can't be loaded 16 bytes at a time. */
+                if (i + 1 == batch->count || batch->lens[i] < 16 ||
+                                batch->lens[i + 1] < 16) {
+                        valid[i] = lines_view(batch->starts[i],
+                                        batch->lens[i], &views[i]);
+                        count += valid[i++];
+                        continue;
+                }
+
+                __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(
+                                        _mm_loadu_si128((const __m128i *)
+                                                batch->starts[i])),
+                                _mm_loadu_si128((const __m128i *)
+                                        batch->starts[i + 1]), 1);
+                __m256i digits = _mm256_sub_epi8(v, _mm256_set1_epi8('0'));
+                __m256i is_digit = _mm256_cmpeq_epi8(_mm256_max_epu8(digits,
+                                        nine), nine);
+                __m256i is_dot = _mm256_cmpeq_epi8(v, dots);
+                __m256i is_stat = _mm256_or_si256(
+                                _mm256_cmpeq_epi8(v, _mm256_set1_epi8('+')),
+                                _mm256_cmpeq_epi8(v, _mm256_set1_epi8('-')));
+                uint32_t mask = ((uint32_t) _mm256_movemask_epi8(is_digit) &
+                                LAYOUT_LANES(LAYOUT_DIGITS)) |
+                        ((uint32_t) _mm256_movemask_epi8(is_dot) &
+                         LAYOUT_LANES(LAYOUT_DOTS)) |
+                        ((uint32_t) _mm256_movemask_epi8(is_stat) &
+                         LAYOUT_LANES(LAYOUT_STATUS));
+
+                for (int lane = 0; lane < 2; lane++, i++) {
+                        valid[i] = ((mask >> (16 * lane)) & LAYOUT_ALL) ==
+                                LAYOUT_ALL && make_view(batch->starts[i],
+                                                batch->lens[i], &views[i]);
+                        count += valid[i];
+                }
+        }
+
+        return count;
+}
+#endif
+
+static bool layout_scalar(const char *line)
+{
+        for (int i = 0; i < DATEOFFSET; i++) {
+                unsigned c = (unsigned char) line[i];
+
+                if (i == 2 || i == 5 ? c != '.' : c - '0' > 9)
+                        return false;
+        }
+
+        return line[STATOFFSET] == '+' || line[STATOFFSET] == '-';
+}
+
+static bool make_view(const char *line, size_t len, TaskView *view)
+{
+        unsigned day = (line[0] - '0') * 10 + (line[1] - '0');
+        unsigned month = (line[3] - '0') * 10 + (line[4] - '0');
+        unsigned year = (line[6] - '0') * 1000 + (line[7] - '0') * 100 +
+                (line[8] - '0') * 10 + (line[9] - '0');
+
+        if (!date_make(day, month, year, &view->date))
+                return false;
+
+        view->status = line[STATOFFSET] == '+';
+        view->subject = len > SUBJOFFSET ? line + SUBJOFFSET : line + len;
+        view->subj_len = len > SUBJOFFSET ? len - SUBJOFFSET : 0;
+        return true;
+}
+
+static size_t split_scalar(const char **pos, const char *end,
+                LineBatch *batch)
+{
+        return split_tail(*pos, *pos, pos, end, batch);
+}
+
+static size_t split_tail(const char *start, const char *from,
+                const char **pos, const char *end, LineBatch *batch)
+{
+        while (batch->count < LINES_BATCH && start < end) {
+                const char *nl = memchr(from, '\n', end - from);
+
+                if (nl == NULL) {
+                        BATCH_ADD(batch, start, end);
+                        start = end;
+                        break;
+                }
+
+                BATCH_ADD(batch, start, nl);
+                start = from = nl + 1;
+        }
+
+        *pos = start;
+        return batch->count;
+}
+
+#ifdef LINES_X86
+static size_t split_sse2(const char **pos, const char *end,
+                LineBatch *batch)
+{
+        const __m128i nl = _mm_set1_epi8('\n');
+        const char *start = *pos;
+        const char *p = *pos;
+
+        while (end - p >= 16) {
+                __m128i v = _mm_loadu_si128((const __m128i *) p);
+                unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(v, nl));
+
+                while (mask != 0) {
+                        const char *stop = p + __builtin_ctz(mask);
+
+                        BATCH_ADD(batch, start, stop);
+                        start = stop + 1;
+                        mask &= mask - 1;
+
+                        if (batch->count == LINES_BATCH) {
+                                *pos = start;
+                                return batch->count;
+                        }
+                }
+
+                p += 16;
+        }
+
+        return split_tail(start, p, pos, end, batch);
+}
+
+__attribute__((target("avx2")))
+static size_t split_avx2(const char **pos, const char *end,
+                LineBatch *batch)
+{
+        const __m256i nl = _mm256_set1_epi8('\n');
+        const char *start = *pos;
+        const char *p = *pos;
+
+        while (end - p >= 32) {
+                __m256i v = _mm256_loadu_si256((const __m256i *) p);
+                uint32_t mask = _mm256_movemask_epi8(
+                                _mm256_cmpeq_epi8(v, nl));
+
+                while (mask != 0) {
+                        const char *stop = p + __builtin_ctz(mask);
+
+                        BATCH_ADD(batch, start, stop);
+                        start = stop + 1;
+                        mask &= mask - 1;
+
+                        if (batch->count == LINES_BATCH) {
+                                *pos = start;
+                                return batch->count;
+                        }
+                }
+
+                p += 32;
+        }
+
+        return split_tail(start, p, pos, end, batch);
+}
+#endif
+
+static void pick_isa(void)
+{
+        const char *forced = getenv(LINES_ISA_ENV);
+
+        if (forced != NULL && strcmp(forced, "scalar") == 0)
+                return;
+
+#ifdef LINES_X86
+        __builtin_cpu_init();
+
+        bool sse2 = __builtin_cpu_supports("sse2");
+        bool avx2 = __builtin_cpu_supports("avx2");
+
+        if (avx2 && (forced == NULL || strcmp(forced, "sse2") != 0)) {
+                split_impl = split_avx2;
+                views_impl = views_avx2;
+                isa_name = "avx2";
+        } else if (sse2) {
+                split_impl = split_sse2;
+                isa_name = "sse2";
+        }
+#endif
+}
@@ -0,0 +1,92 @@
+/**
+ * @file lines.h
+ * @brief Interface for the vectorized task line tokenizer.
+ *
+ * Task files and history are split into lines in batches: newlines of
+ * a whole 16- or 32-byte block are found with one vector compare, and
+ * lines are cut from the resulting bit mask without calling memchr() for
+ * every line. The fixed "dd.mm.yyyy S " prefix of a task line is checked
+ * with one vector compare as well, and only the digits are then combined
+ * into a date. With AVX2 the prefixes of two lines of a batch are checked
+ * by the same compare.
+ *
+ * Implementation is picked at runtime: AVX2 or SSE2 on x86 processors
+ * which have them, and plain C everywhere else. LINES_ISA_ENV may force
+ * a simpler implementation, which is useful to compare them.
+ *
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#ifndef LINES_H
+#define LINES_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "types.h"
+
+/** Maximum number of lines split by one call of lines_split(). */
+#define LINES_BATCH   256
+
+/** Environment variable which forces "scalar", "sse2" or "avx2" code. */
+#define LINES_ISA_ENV "DOIT_ISA"
+
+/**
+ * @brief Type definition for the batch of lines.
+ */
+typedef struct LineBatch_tag {
+        const char *starts[LINES_BATCH]; ///< First bytes of the lines.
+        uint32_t   lens[LINES_BATCH]; ///< Lengths without the terminator.
+        size_t     count; ///< Number of lines in the batch.
+} LineBatch;
+
+/**
+ * @brief Splits next lines.
+ *
+ * Stores at most LINES_BATCH lines starting at @p pos into @p batch and
+ * moves @p pos past them. Lines are split the same way as next_line()
+ * does, the last line may have no terminator.
+ *
+ * @param[in,out] pos Pointer to the current position.
+ * @param[in] end Pointer to the first byte after the text.
+ * @param[in,out] batch Pointer to the batch, which is to be filled.
+ * @return Number of lines in the batch, 0 at the end of the text.
+ */
+size_t lines_split(const char **pos, const char *end, LineBatch *batch);
+
+/**
+ * @brief Parses task line.
+ *
+ * Checks the date layout and the status column of the line specified by
+ * @p line and @p len and fills @p view on success. Works like
+ * parse_view(), but never warns, so it can be used on any text.
+ *
+ * @param[in] line Read-only line, not terminated.
+ * @param[in] len Length of the line.
+ * @param[in,out] view Pointer to the view, which is to be set.
+ * @return True if the line holds a valid task, or false otherwise.
+ */
+bool lines_view(const char *line, size_t len, TaskView *view);
+
+/**
+ * @brief Parses all the lines of the batch.
+ *
+ * Works like lines_view() called for every line of @p batch, but checks
+ * several lines per vector compare where the processor allows it.
+ *
+ * @param[in] batch Pointer to the read-only batch.
+ * @param[in,out] views Array of LINES_BATCH views, which are to be set.
+ * @param[in,out] valid Array of LINES_BATCH flags, set for valid lines.
+ * @return Number of valid lines.
+ */
+size_t lines_views(const LineBatch *batch, TaskView *views, bool *valid);
+
+/**
+ * @brief Gets name of the implementation in use.
+ * @return Read-only string "scalar", "sse2" or "avx2".
+ */
+const char *lines_isa(void);
+
+#endif
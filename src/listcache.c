@@ -0,0 +1,131 @@
+/**
+ * @file listcache.c
+ * @brief Function definitions for the cache of open task lists.
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#include <string.h>
+
+#include "error.h"
+#include "listcache.h"
+#include "tasks.h"
+
+/**
+ * @brief Finds the slot for the list specified by @p name.
+ * @return Pointer to the slot with the list, or NULL if it's not loaded.
+ */
+static OpenList *find_list(ListCache *cache, const char *name);
+
+/**
+ * @brief Finds a free slot, or the least recently used one if all are busy.
+ * @return Pointer to the slot.
+ */
+static OpenList *pick_slot(ListCache *cache);
+
+/**
+ * @brief Saves and releases the list held in @p slot, freeing the slot.
+ * @return True if the list was saved, or false otherwise.
+ */
+static bool drop_list(OpenList *slot, bool save);
+
+void list_cache_init(ListCache *cache)
+{
+        memset(cache, 0, sizeof(ListCache));
+
+        for (int i = 0; i < LIST_CACHE_SIZE; i++)
+                cache->lists[i].journal.fd = -1;
+}
+
+Tasks *list_cache_open(ListCache *cache, const char *name, ListLoadFn load)
+{
+        if (cache == NULL || load == NULL || !list_name_is_valid(name)) {
+                FAIL(ERR_PARAM, "Bad parameter -> can't open list.");
+                return NULL;
+        }
+
+        char prev[LIST_NAMESIZE];
+        snprintf(prev, sizeof(prev), "%s", list_paths()->name);
+
+        if (!list_use(name))
+                return NULL;
+
+        OpenList *slot = find_list(cache, name);
+
+        if (slot) {
+                slot->used = ++cache->clock;
+                return &slot->entry;
+        }
+
+        slot = pick_slot(cache);
+
+        /* Dropped list is saved, so a failure only means a longer replay. */
+        if (slot->used != 0 && !drop_list(slot, true))
+                WARNING("Failed to save dropped list.");
+
+        slot->paths = *list_paths();
+        init_tasks(&slot->entry);
+
+        bool ret = load(&slot->entry);
+        CHECK(ret, "Failed to load list.");
+
+        /* Journal keeps pointers to the names, so they live in the slot. */
+        ret = journal_open(&slot->journal, slot->paths.journal,
+                        slot->paths.last_entry) &&
+                journal_compact(&slot->journal, &slot->entry);
+        CHECK(ret, "Failed to start journal.");
+
+        slot->entry.journal = &slot->journal;
+        slot->used = ++cache->clock;
+        return &slot->entry;
+
+error:
+        journal_close(&slot->journal);
+        destroy_tasks(&slot->entry);
+        slot->used = 0;
+        list_use(prev);
+        return NULL;
+}
+
+bool list_cache_close(ListCache *cache, bool save)
+{
+        bool ok = true;
+
+        for (int i = 0; i < LIST_CACHE_SIZE; i++)
+                if (cache->lists[i].used != 0 &&
+                                !drop_list(&cache->lists[i], save))
+                        ok = false;
+
+        return ok;
+}
+
+static OpenList *find_list(ListCache *cache, const char *name)
+{
+        for (int i = 0; i < LIST_CACHE_SIZE; i++)
+                if (cache->lists[i].used != 0 &&
+                                STRCMP(cache->lists[i].paths.name, ==, name))
+                        return &cache->lists[i];
+
+        return NULL;
+}
+
+static OpenList *pick_slot(ListCache *cache)
+{
+        OpenList *lru = &cache->lists[0];
+
+        for (int i = 0; i < LIST_CACHE_SIZE; i++)
+                if (cache->lists[i].used < lru->used)
+                        lru = &cache->lists[i];
+
+        return lru;
+}
+
+static bool drop_list(OpenList *slot, bool save)
+{
+        bool ok = !save || journal_compact(&slot->journal, &slot->entry);
+
+        journal_close(&slot->journal);
+        destroy_tasks(&slot->entry);
+        slot->used = 0;
+        return ok;
+}
@@ -0,0 +1,90 @@
+/**
+ * @file listcache.h
+ * @brief Interface for the cache of open task lists.
+ *
+ * Interactive mode keeps the few most recently used lists loaded, each
+ * with its own open journal, so switching back to one of them costs no
+ * file reading at all. When the cache is full, the least recently used
+ * list is saved and dropped to make room for the new one.
+ *
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#ifndef LISTCACHE_H
+#define LISTCACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "journal.h"
+#include "lists.h"
+#include "types.h"
+
+/** Number of lists kept loaded at once. */
+#define LIST_CACHE_SIZE 4
+
+/**
+ * @brief Type definition for a loaded list.
+ */
+typedef struct OpenList_tag {
+        ListPaths paths; ///< File names of the list, used by the journal.
+        Tasks     entry; ///< Last entry of the list.
+        Journal   journal; ///< Open journal of the entry.
+        uint64_t  used; ///< Time of the last use, or 0 for a free slot.
+} OpenList;
+
+/**
+ * @brief Type definition for the cache of loaded lists.
+ */
+typedef struct ListCache_tag {
+        OpenList lists[LIST_CACHE_SIZE]; ///< Slots of loaded lists.
+        uint64_t clock; ///< Time of the latest use.
+} ListCache;
+
+/**
+ * @brief Type definition for the function which loads the last entry.
+ *
+ * Reads the entry of the list in use into the empty list specified by
+ * the parameter.
+ */
+typedef bool (*ListLoadFn)(Tasks *entry);
+
+/**
+ * @brief Initializes cache.
+ * @param[in,out] cache Pointer to the cache.
+ * @return Nothing.
+ */
+void list_cache_init(ListCache *cache);
+
+/**
+ * @brief Switches to list.
+ *
+ * Makes the list specified by @p name the list in use. A list which is
+ * in the cache is used as it is. Otherwise the least recently used list
+ * is saved and dropped if there is no free slot, the entry is loaded with
+ * @p load and its journal is opened. On failure the list in use stays
+ * the same.
+ *
+ * @param[in,out] cache Pointer to the cache.
+ * @param[in] name Read-only string with the list name, empty for the
+ *            default list.
+ * @param[in] load Function which loads the entry.
+ * @return Pointer to the entry of the list, or NULL on failure.
+ */
+Tasks *list_cache_open(ListCache *cache, const char *name, ListLoadFn load);
+
+/**
+ * @brief Closes cache.
+ *
+ * Saves all the loaded lists if @p save is set, closes their journals and
+ * releases them. Journals of lists which aren't saved are kept, so they
+ * are replayed on the next start.
+ *
+ * @param[in,out] cache Pointer to the cache.
+ * @param[in] save True to save the lists.
+ * @return True if every list was saved, or false otherwise.
+ */
+bool list_cache_close(ListCache *cache, bool save);
+
+#endif
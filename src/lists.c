@@ -0,0 +1,96 @@
+/**
+ * @file lists.c
+ * @brief Function definitions for named task lists.
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "error.h"
+#include "lists.h"
+
+/**
+ * @brief Makes file names of the list in @p dir.
+ * @param[in,out] paths Pointer to the file names, which are to be set.
+ * @param[in] name Read-only string with the list name.
+ * @param[in] dir Read-only string with the list directory.
+ * @return Nothing.
+ */
+static void make_paths(ListPaths *paths, const char *name, const char *dir);
+
+/** File names of the list in use, the default list until one is chosen. */
+static ListPaths current = {
+        "", LISTS_DIR, LISTS_DIR "/last_entry.txt", LISTS_DIR "/last_entry.log",
+        LISTS_DIR "/history.txt", LISTS_DIR "/history.idx",
+        LISTS_DIR "/history", LISTS_DIR "/history/manifest.txt",
+        LISTS_DIR "/history/migration.txt", LISTS_DIR "/history/words.idx"
+};
+
+bool list_name_is_valid(const char *name)
+{
+        if (name == NULL)
+                return false;
+
+        size_t len = strlen(name);
+
+        if (len >= LIST_NAMESIZE)
+                return false;
+
+        for (size_t i = 0; i < len; i++)
+                if (!isalnum((unsigned char) name[i]) && name[i] != '-' &&
+                                name[i] != '_')
+                        return false;
+
+        return true;
+}
+
+bool list_use(const char *name)
+{
+        if (!list_name_is_valid(name)) {
+                FAIL(ERR_PARAM, "Bad parameter -> name isn't valid.");
+                return false;
+        }
+
+        char dir[LIST_PATHSIZE] = LISTS_DIR;
+
+        if (name[0] != '\0') {
+                snprintf(dir, sizeof(dir), "%s/%s", LISTS_NAMED_DIR, name);
+
+                if ((mkdir(LISTS_NAMED_DIR, 0755) < 0 && errno != EEXIST) ||
+                                (mkdir(dir, 0755) < 0 && errno != EEXIST)) {
+                        FAIL(ERR_IO, "Failed to create list directory.");
+                        return false;
+                }
+
+                errno = 0;
+        }
+
+        make_paths(&current, name, dir);
+        return true;
+}
+
+const ListPaths *list_paths(void)
+{
+        return &current;
+}
+
+static void make_paths(ListPaths *paths, const char *name, const char *dir)
+{
+        snprintf(paths->name, LIST_NAMESIZE, "%s", name);
+        snprintf(paths->dir, LIST_PATHSIZE, "%s", dir);
+        snprintf(paths->last_entry, LIST_PATHSIZE, "%s/last_entry.txt", dir);
+        snprintf(paths->journal, LIST_PATHSIZE, "%s/last_entry.log", dir);
+        snprintf(paths->history, LIST_PATHSIZE, "%s/history.txt", dir);
+        snprintf(paths->history_idx, LIST_PATHSIZE, "%s/history.idx", dir);
+        snprintf(paths->history_dir, LIST_PATHSIZE, "%s/history", dir);
+        snprintf(paths->manifest, LIST_PATHSIZE, "%s/history/manifest.txt",
+                        dir);
+        snprintf(paths->migration, LIST_PATHSIZE,
+                        "%s/history/migration.txt", dir);
+        snprintf(paths->words, LIST_PATHSIZE, "%s/history/words.idx", dir);
+}
@@ -0,0 +1,78 @@
+/**
+ * @file lists.h
+ * @brief Interface for named task lists.
+ *
+ * Every list keeps its entry, journal and history in a directory of its
+ * own. The default list lives right in ./txt, as it always has, and
+ * a named list lives in ./txt/lists/NAME. File names of the list in use
+ * are made once when the list is selected, and the path macros of
+ * types.h, history.h and windex.h read them from there.
+ *
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#ifndef LISTS_H
+#define LISTS_H
+
+#include <stdbool.h>
+
+/** Directory of the default list. */
+#define LISTS_DIR       "./txt"
+
+/** Directory which contains named lists. */
+#define LISTS_NAMED_DIR LISTS_DIR "/lists"
+
+/** Maximum length of a list name, including '\0'. */
+#define LIST_NAMESIZE   32
+
+/** Size of the buffer for a file name of a list. */
+#define LIST_PATHSIZE   96
+
+/**
+ * @brief Type definition for the file names of a list.
+ */
+typedef struct ListPaths_tag {
+        char name[LIST_NAMESIZE]; ///< List name, empty for the default list.
+        char dir[LIST_PATHSIZE]; ///< Directory of the list.
+        char last_entry[LIST_PATHSIZE]; ///< File with the last entry.
+        char journal[LIST_PATHSIZE]; ///< Journal of the last entry.
+        char history[LIST_PATHSIZE]; ///< Single-file history of old versions.
+        char history_idx[LIST_PATHSIZE]; ///< Its date index.
+        char history_dir[LIST_PATHSIZE]; ///< Directory of history segments.
+        char manifest[LIST_PATHSIZE]; ///< List of history segments.
+        char migration[LIST_PATHSIZE]; ///< Segments before history.txt moved.
+        char words[LIST_PATHSIZE]; ///< Word index of the history.
+} ListPaths;
+
+/**
+ * @brief Checks list name.
+ *
+ * Valid name is empty, for the default list, or is made of at most
+ * LIST_NAMESIZE - 1 letters, digits, '-' and '_'.
+ *
+ * @param[in] name Read-only string with the name.
+ * @return True if the name is valid, or false otherwise.
+ */
+bool list_name_is_valid(const char *name);
+
+/**
+ * @brief Selects list.
+ *
+ * Makes the list specified by @p name the list in use, creating its
+ * directory if needed. Must not be called while other threads use the
+ * file names.
+ *
+ * @param[in] name Read-only string with the list name, empty for the
+ *            default list.
+ * @return True on success, or false otherwise.
+ */
+bool list_use(const char *name);
+
+/**
+ * @brief Gets file names of the list in use.
+ * @return Pointer to the read-only file names.
+ */
+const ListPaths *list_paths(void);
+
+#endif
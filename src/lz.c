@@ -0,0 +1,176 @@
+/**
+ * @file lz.c
+ * @brief Function definitions for the built-in LZ block codec.
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#include "lz.h"
+
+/**
+ * @brief Writes length nibble overflow.
+ * @param[in,out] op Pointer to the output position.
+ * @param[in] len Length minus 15.
+ * @return Nothing.
+ */
+static void put_length(unsigned char **op, size_t len);
+
+/**
+ * @brief Reads length nibble overflow.
+ * @param[in,out] ip Pointer to the input position.
+ * @param[in] end Pointer to the end of the input.
+ * @param[in,out] len Pointer to the length, which is to be increased.
+ * @return True on success, or false if the input ends.
+ */
+static bool get_length(const unsigned char **ip, const unsigned char *end,
+                size_t *len);
+
+/**
+ * @brief Hashes four bytes for the match finder.
+ */
+static uint32_t hash4(const unsigned char *p);
+
+size_t lz_compress(const char *src, size_t len, char *dst)
+{
+        const unsigned char *in = (const unsigned char *) src;
+        unsigned char *op = (unsigned char *) dst;
+        uint32_t table[1 << LZ_HASH_BITS] = { 0 };
+        size_t anchor = 0;
+        size_t ip = 0;
+
+        /* Table holds position plus one, so zero means no candidate. */
+        while (len >= LZ_MIN_MATCH && ip <= len - LZ_MIN_MATCH) {
+                uint32_t h = hash4(in + ip);
+                size_t ref = table[h];
+
+                table[h] = ip + 1;
+
+                if (ref == 0 || ip - (ref - 1) > LZ_MAX_OFFSET ||
+                                memcmp(in + ref - 1, in + ip,
+                                        LZ_MIN_MATCH) != 0) {
+                        ++ip;
+                        continue;
+                }
+
+                --ref;
+
+                size_t match = LZ_MIN_MATCH;
+
+                while (ip + match < len && in[ref + match] == in[ip + match])
+                        ++match;
+
+                size_t lits = ip - anchor;
+                unsigned char *token = op++;
+
+                *token = (lits < 15 ? lits : 15) << 4;
+                if (lits >= 15)
+                        put_length(&op, lits - 15);
+
+                memcpy(op, in + anchor, lits);
+                op += lits;
+
+                *op++ = (ip - ref) & 0xff;
+                *op++ = (ip - ref) >> 8;
+
+                size_t extra = match - LZ_MIN_MATCH;
+
+                *token |= extra < 15 ? extra : 15;
+                if (extra >= 15)
+                        put_length(&op, extra - 15);
+
+                ip += match;
+                anchor = ip;
+        }
+
+        size_t lits = len - anchor;
+
+        *op++ = (lits < 15 ? lits : 15) << 4;
+        if (lits >= 15)
+                put_length(&op, lits - 15);
+
+        memcpy(op, in + anchor, lits);
+        op += lits;
+
+        return op - (unsigned char *) dst;
+}
+
+bool lz_decompress(const char *src, size_t len, char *dst, size_t raw_len)
+{
+        const unsigned char *ip = (const unsigned char *) src;
+        const unsigned char *end = ip + len;
+        size_t pos = 0;
+
+        while (ip < end) {
+                unsigned token = *ip++;
+                size_t lits = token >> 4;
+
+                if (lits == 15 && !get_length(&ip, end, &lits))
+                        return false;
+
+                if (lits > (size_t) (end - ip) || lits > raw_len - pos)
+                        return false;
+
+                memcpy(dst + pos, ip, lits);
+                ip += lits;
+                pos += lits;
+
+                if (ip == end)
+                        break;
+
+                if (end - ip < 2)
+                        return false;
+
+                size_t offset = ip[0] | (size_t) ip[1] << 8;
+                size_t match = token & 0x0f;
+
+                ip += 2;
+
+                if (match == 15 && !get_length(&ip, end, &match))
+                        return false;
+
+                match += LZ_MIN_MATCH;
+
+                if (offset == 0 || offset > pos || match > raw_len - pos)
+                        return false;
+
+                /* Match may overlap the bytes it produces. */
+                for (size_t i = 0; i < match; i++, pos++)
+                        dst[pos] = dst[pos - offset];
+        }
+
+        return pos == raw_len;
+}
+
+static void put_length(unsigned char **op, size_t len)
+{
+        while (len >= 255) {
+                *(*op)++ = 255;
+                len -= 255;
+        }
+
+        *(*op)++ = len;
+}
+
+static bool get_length(const unsigned char **ip, const unsigned char *end,
+                size_t *len)
+{
+        unsigned char byte = 255;
+
+        while (byte == 255) {
+                if (*ip == end)
+                        return false;
+
+                byte = *(*ip)++;
+                *len += byte;
+        }
+
+        return true;
+}
+
+static uint32_t hash4(const unsigned char *p)
+{
+        uint32_t v = p[0] | (uint32_t) p[1] << 8 | (uint32_t) p[2] << 16 |
+                (uint32_t) p[3] << 24;
+
+        return (v * UINT32_C(2654435761)) >> (32 - LZ_HASH_BITS);
+}
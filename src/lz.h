@@ -0,0 +1,66 @@
+/**
+ * @file lz.h
+ * @brief Interface for the built-in LZ block codec.
+ *
+ * Small byte-oriented LZ77 codec used for history archives. Compressed
+ * block is a chain of sequences. Every sequence starts with a token byte:
+ * high nibble is the number of literals, low nibble is the match length
+ * minus LZ_MIN_MATCH. Nibble value 15 is followed by extra bytes which are
+ * added to it until a byte below 255. Token is followed by the literals,
+ * then by a two-byte little-endian match offset and extra match length
+ * bytes. The last sequence has literals only.
+ *
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#ifndef LZ_H
+#define LZ_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/** Shortest match the codec encodes. */
+#define LZ_MIN_MATCH  4
+
+/** Longest distance to a match. */
+#define LZ_MAX_OFFSET 65535
+
+/** Number of bits of the match finder hash. */
+#define LZ_HASH_BITS  12
+
+/** Evaluates to the largest compressed size of @p n input bytes. */
+#define LZ_BOUND(n)   ((n) + (n) / 255 + 16)
+
+/**
+ * @brief Compresses block.
+ *
+ * Compresses @p len bytes of @p src into @p dst, which must hold at least
+ * LZ_BOUND(@p len) bytes.
+ *
+ * @param[in] src Bytes to be compressed.
+ * @param[in] len Number of bytes.
+ * @param[in,out] dst Buffer, where compressed bytes are to be stored.
+ * @return Number of compressed bytes.
+ */
+size_t lz_compress(const char *src, size_t len, char *dst);
+
+/**
+ * @brief Decompresses block.
+ *
+ * Decompresses @p len bytes of @p src into @p dst, which holds exactly
+ * @p raw_len bytes. Damaged input never makes it read or write out of
+ * bounds.
+ *
+ * @param[in] src Compressed bytes.
+ * @param[in] len Number of compressed bytes.
+ * @param[in,out] dst Buffer, where decompressed bytes are to be stored.
+ * @param[in] raw_len Size of the decompressed block.
+ * @return True if exactly @p raw_len bytes were decoded, or false
+ *         otherwise.
+ */
+bool lz_decompress(const char *src, size_t len, char *dst, size_t raw_len);
+
+#endif
@@ -8,81 +8,191 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "batch.h"
 #include "date.h"
 #include "error.h"
 #include "io.h"
+#include "journal.h"
+#include "listcache.h"
+#include "lists.h"
+#include "store.h"
 #include "tasks.h"
 #include "types.h"
 
+/**
+ * @brief Loads the last entry.
+ *
+ * Replays the journal left by an abnormal exit, then reads last_entry.txt
+ * in any format into the list specified by @p entry. If the entry is
+ * outdated, it's moved to the history instead and the list stays empty.
+ *
+ * @param[in,out] entry Pointer to the task list.
+ * @return True on success, or false otherwise.
+ */
+static bool load_entry(Tasks *entry);
+
+/**
+ * @brief Saves the entry.
+ *
+ * Atomically replaces last_entry.txt with the list specified by @p entry,
+ * so a crash during the save never leaves a truncated file behind. The
+ * file keeps its format, text or binary.
+ *
+ * @param[in] entry Pointer to the task list.
+ * @return True on success, or false otherwise.
+ */
+static bool save_entry(Tasks *entry);
+
+/**
+ * @brief Applies batch operations and saves the entry once.
+ *
+ * @param[in,out] entry Pointer to the task list.
+ * @param[in] path Name of the file with operations, or NULL for stdin.
+ * @param[in] dedup True to skip tasks the entry already has.
+ * @return EXIT_SUCCESS on success, or EXIT_FAILURE otherwise.
+ */
+static int run_batch_mode(Tasks *entry, const char *path, bool dedup);
+
+/**
+ * @brief Converts the entry between the text and binary formats.
+ *
+ * With @p to_text set writes last_entry.txt as text into the file
+ * specified by @p path, or to stdout if @p path is NULL. Otherwise reads
+ * the text file specified by @p path and stores it as binary
+ * last_entry.txt. Either file may be last_entry.txt itself.
+ *
+ * @param[in,out] entry Pointer to the task list.
+ * @param[in] to_text True to export text, false to import it.
+ * @param[in] path Name of the text file, or NULL for stdout.
+ * @return EXIT_SUCCESS on success, or EXIT_FAILURE otherwise.
+ */
+static int run_convert(Tasks *entry, bool to_text, const char *path);
+
+/**
+ * @brief Sets where reports go.
+ *
+ * Adds the log file named by ERR_LOG_ENV to the sinks specified by
+ * @p sinks, if the variable is set. A log file which can't be opened is
+ * reported to stderr and left out.
+ *
+ * @param[in] sinks Combination of ErrSink values.
+ * @return Nothing.
+ */
+static void set_sinks(int sinks);
+
 /**
  * @brief Main function.
- * TODO: add detailed description of the main function.
+ *
+ * Without arguments runs the interactive loop. With --batch applies
+ * operations read from the file given after it, or from stdin, and
+ * saves the entry once at the end. Operations are described in batch.h.
+ * With --dedup after --batch, added tasks which the entry already has
+ * are skipped.
+ * With --export-text or --import-text converts last_entry.txt between
+ * the text and binary formats.
+ * With -l NAME first, works with the named list instead of the default
+ * one. Interactive mode loads other lists only when they're switched to
+ * and keeps the recently used ones loaded, see listcache.h.
+ *
+ * @param[in] argc Number of arguments.
+ * @param[in] argv Array of arguments.
  * @return EXIT_SUCCESS on success, or EXIT_FAILURE otherwise.
  */
-int main(void)
+int main(int argc, char *argv[])
 {
-        atexit(clear_scr);
+        const char *prog = argv[0];
+        const char *list = "";
 
-        Tasks entry;
-        init_tasks(&entry, destroy_task);
+        if (argc > 2 && STRCMP(argv[1], ==, "-l")) {
+                list = argv[2];
+                argv += 2;
+                argc -= 2;
+        }
 
-        FILE *last_entry_fp = fopen(LAST_ENTRY, "a+");
-        CHECK(last_entry_fp, "Failed to create/open last_entry.txt.");
+        set_sinks(ERR_SINK_STDERR);
 
-        bool ret = false;
+        if (!list_name_is_valid(list)) {
+                fprintf(stderr, "doit: bad list name: %s\n", list);
+                exit(EXIT_FAILURE);
+        }
 
-        if (!file_is_empty(last_entry_fp)) {
-                char date[DATESIZE];
-                ret = get_last_entry_date(last_entry_fp, date);
-                CHECK(ret, "Failed to get last entry date.");
-
-                if (is_outdated(date)) {
-                        ret = save_entry_to_history(last_entry_fp);
-                        CHECK(ret, "Failed to save entry to history.");
-                } else {
-                        ret = read_entry_from_file(last_entry_fp, &entry);
-                        CHECK(ret, "Failed to read entry form file.");
-                }
+        if (!list_use(list))
+                exit(EXIT_FAILURE);
+
+        if (argc > 1) {
+                Tasks entry;
+                init_tasks(&entry);
+
+                bool dedup = argc > 2 && STRCMP(argv[2], ==, "--dedup");
+                int path_arg = dedup ? 3 : 2;
+
+                if (STRCMP(argv[1], ==, "--batch") && argc <= path_arg + 1)
+                        exit(run_batch_mode(&entry, argc > path_arg ?
+                                                argv[path_arg] : NULL, dedup));
+
+                if (STRCMP(argv[1], ==, "--export-text") && argc <= 3)
+                        exit(run_convert(&entry, true, argc == 3 ? argv[2] :
+                                                NULL));
+
+                if (STRCMP(argv[1], ==, "--import-text") && argc == 3)
+                        exit(run_convert(&entry, false, argv[2]));
+
+                fprintf(stderr, "usage: %s [-l name] [--batch [--dedup] "
+                                "[file] | --export-text [file] | "
+                                "--import-text file]\n", prog);
+                exit(EXIT_FAILURE);
         }
 
-        CHECK(show_tasks(&entry), "Failed to show tasks.");
+        atexit(clear_scr);
+
+        /* Reports wait in the ring until the screen can show them. */
+        set_sinks(ERR_SINK_RING);
+
+        ListCache cache;
+        list_cache_init(&cache);
 
-        fclose(last_entry_fp);
-        last_entry_fp = NULL;
+        /* Lists open with the journal running, every change is logged. */
+        Tasks *entry = list_cache_open(&cache, list, load_entry);
+        CHECK(entry, "Failed to load last entry.");
 
-        char *options = get_valid_opts(&entry);
-        char option = get_opt(&entry, options);
+        show_reports("Press <Enter> to continue...");
+        CHECK(show_tasks(entry), "Failed to show tasks.");
+
+        char *options = get_valid_opts(entry);
+        char option = get_opt(entry, options);
         long task_index = 0L;
+        bool ret = false;
+        char name[LIST_NAMESIZE] = { 0 };
+        Tasks *next = NULL;
 
         while (option != 'q') {
                 switch (option) {
                         case 'a':
-                                ret = add_task(&entry, NULL, UNDONE);
+                                ret = get_task(entry);
                                 CHECK(ret, "Failed to add task.");
                                 break;
 
                         case 'c':
-                                task_index = get_index(&entry);
+                                task_index = get_index(entry);
                                 CHECK(task_index > -1L, "Failed to get index.");
-                                ret = change_task(&entry, task_index);
+                                ret = get_new_subject(entry, task_index);
                                 CHECK(ret, "Failed to change task.");
                                 break;
 
                         case 'd':
-                                task_index = get_index(&entry);
+                                task_index = get_index(entry);
                                 CHECK(task_index > -1L, "Failed to get index.");
-                                ret = delete_task(&entry, task_index);
+                                ret = delete_task(entry, task_index);
                                 CHECK(ret, "Failed to delete task.");
                                 break;
 
                         case 'e':
-                                ret = erase_history(&entry);
+                                ret = erase_history(entry);
                                 CHECK(ret, "Failed to erase history.");
                                 break;
 
                         case 'D':
-                                destroy_tasks(&entry);
-                                init_tasks(&entry, destroy_task);
+                                reset_tasks(entry);
                                 break;
 
                         case 'h':
@@ -94,31 +204,51 @@ int main(void)
                                 CHECK(ret, "Failed to show history.");
                                 break;
 
+                        case 'L':
+                                /* Failed switch leaves the current list. */
+                                next = get_list_name(entry, name) ?
+                                        list_cache_open(&cache, name,
+                                                        load_entry) : NULL;
+
+                                if (next)
+                                        entry = next;
+                                break;
+
+                        case 'f':
+                                ret = find_history(entry);
+                                CHECK(ret, "Failed to find in history.");
+                                break;
+
+                        case 'r':
+                                ret = query_history(entry);
+                                CHECK(ret, "Failed to query history.");
+                                break;
+
                         case 's':
-                                ret = search_history(&entry);
+                                ret = search_history(entry);
                                 CHECK(ret, "Failed to search history.");
                                 break;
 
                         case 'u':
-                                task_index = get_index(&entry);
+                                task_index = get_index(entry);
                                 CHECK(task_index > -1L, "Failed to get index.");
-                                ret = undo_task(&entry, task_index);
+                                ret = undo_task(entry, task_index);
                                 CHECK(ret, "Failed to undo task.");
                                 break;
 
                         case 'U':
-                                traverse_tasks(&entry, uncheck_done);
+                                set_all_tasks(entry, UNDONE);
                                 break;
 
                         case 'x':
-                                task_index = get_index(&entry);
+                                task_index = get_index(entry);
                                 CHECK(task_index > -1L, "Failed to get index.");
-                                ret = do_task(&entry, task_index);
+                                ret = do_task(entry, task_index);
                                 CHECK(ret, "Failed to do task.");
                                 break;
 
                         case 'X':
-                                traverse_tasks(&entry, check_as_done);
+                                set_all_tasks(entry, DONE);
                                 break;
 
                         default:
@@ -126,26 +256,142 @@ int main(void)
                                 goto error;
                 }
 
-                options = get_valid_opts(&entry);
-                option = get_opt(&entry, options);
+                show_reports("Press <Enter> to continue...");
+                options = get_valid_opts(entry);
+                option = get_opt(entry, options);
+        }
+
+        CHECK(list_cache_close(&cache, true),
+                        "Failed to save last_entry.txt.");
+        exit(EXIT_SUCCESS);
+
+error:
+        show_reports("Press <Enter> to exit the program...");
+        list_cache_close(&cache, false);
+        exit(EXIT_FAILURE);
+}
+
+static bool load_entry(Tasks *entry)
+{
+        if (!journal_recover(JOURNAL, LAST_ENTRY)) {
+                WARNING("Failed to replay journal.");
+                return false;
         }
 
-        last_entry_fp = fopen(LAST_ENTRY, "w");
-        CHECK(last_entry_fp, "Failed to create/open last_entry.txt.");
+        bool ret = read_entry(LAST_ENTRY, entry);
+        CHECK(ret, "Failed to read entry form file.");
 
-        if (tasks_size(&entry) > 0)
-                write_entry_to_file(last_entry_fp, &entry);
+        if (tasks_size(entry) > 0 && is_outdated(task_date(entry, 1))) {
+                size_t len = 0;
+                char *text = serialize_entry(entry, ENTRY_TEXT, &len);
+                CHECK(text, "Failed to serialize entry.");
 
-        fclose(last_entry_fp);
-        last_entry_fp = NULL;
-        destroy_tasks(&entry);
-        exit(EXIT_SUCCESS);
+                /* History is kept as text whatever the entry format is. */
+                FILE *text_fp = fmemopen(text, len, "r");
+
+                ret = text_fp && save_entry_to_history(text_fp);
+
+                if (text_fp)
+                        fclose(text_fp);
+                text_fp = NULL;
+                free(text);
+                text = NULL;
+                CHECK(ret, "Failed to save entry to history.");
+
+                reset_tasks(entry);
+        }
+
+        return true;
 
 error:
-        if (last_entry_fp)
-                fclose(last_entry_fp);
-        last_entry_fp = NULL;
+        reset_tasks(entry);
+        return false;
+}
 
-        destroy_tasks(&entry);
-        exit(EXIT_FAILURE);
+static bool save_entry(Tasks *entry)
+{
+        return store_entry(LAST_ENTRY, entry, entry_format(LAST_ENTRY));
+}
+
+static int run_batch_mode(Tasks *entry, const char *path, bool dedup)
+{
+        FILE *ops_fp = path ? fopen(path, "r") : stdin;
+
+        if (ops_fp == NULL) {
+                fprintf(stderr, "doit: can't open %s: %s\n", path,
+                                CLEAN_ERRNO());
+                return EXIT_FAILURE;
+        }
+
+        err_clear();
+
+        /* Entry which failed to load is left as it is on disk. */
+        if (!load_entry(entry) || (dedup && !dedup_tasks(entry, true))) {
+                if (path)
+                        fclose(ops_fp);
+
+                fprintf(stderr, "doit: can't load entry: %s\n",
+                                err_name(err_last()->code));
+                destroy_tasks(entry);
+                return EXIT_FAILURE;
+        }
+
+        bool ok = run_batch(entry, ops_fp);
+
+        /* Operations that succeeded are kept even if some have failed. */
+        if (!save_entry(entry))
+                ok = false;
+
+        if (path)
+                fclose(ops_fp);
+
+        if (!ok)
+                fprintf(stderr, "doit: batch failed: %s\n",
+                                err_name(err_last()->code));
+
+        destroy_tasks(entry);
+        return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int run_convert(Tasks *entry, bool to_text, const char *path)
+{
+        err_clear();
+
+        bool ok = journal_recover(JOURNAL, LAST_ENTRY) &&
+                read_entry(to_text ? LAST_ENTRY : path, entry);
+
+        if (ok && to_text && path == NULL) {
+                size_t len = 0;
+                char *text = serialize_entry(entry, ENTRY_TEXT, &len);
+
+                ok = text && fwrite(text, 1, len, stdout) == len;
+                free(text);
+                text = NULL;
+        } else if (ok) {
+                ok = store_entry(to_text ? path : LAST_ENTRY, entry,
+                                to_text ? ENTRY_TEXT : ENTRY_BINARY);
+        }
+
+        if (!ok)
+                fprintf(stderr, "doit: conversion failed: %s\n",
+                                err_name(err_last()->code));
+
+        destroy_tasks(entry);
+        return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static void set_sinks(int sinks)
+{
+        const char *log = getenv(ERR_LOG_ENV);
+
+        if (log == NULL || *log == '\0') {
+                err_sink(sinks, NULL);
+                return;
+        }
+
+        if (err_sink(sinks | ERR_SINK_FILE, log))
+                return;
+
+        fprintf(stderr, "doit: can't open %s: %s\n", log, CLEAN_ERRNO());
+        err_sink(sinks, NULL);
 }
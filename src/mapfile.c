@@ -0,0 +1,77 @@
+/**
+ * @file mapfile.c
+ * @brief Function definitions for read-only memory-mapped files.
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#include "mapfile.h"
+
+bool map_file(const char *path, MapFile *map)
+{
+        if (path == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> path == NULL.");
+                return false;
+        }
+
+        if (map == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> map == NULL.");
+                return false;
+        }
+
+        map->data = NULL;
+        map->size = 0;
+
+        int fd = open(path, O_RDONLY);
+
+        if (fd < 0)
+                return false;
+
+        struct stat st;
+
+        if (fstat(fd, &st) < 0) {
+                close(fd);
+                return false;
+        }
+
+        if (st.st_size > 0) {
+                void *addr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE,
+                                fd, 0);
+
+                if (addr == MAP_FAILED) {
+                        close(fd);
+                        return false;
+                }
+
+                map->data = addr;
+                map->size = st.st_size;
+        }
+
+        close(fd);
+        return true;
+}
+
+void unmap_file(MapFile *map)
+{
+        if (map == NULL || map->data == NULL)
+                return;
+
+        munmap((void *) map->data, map->size);
+        map->data = NULL;
+        map->size = 0;
+}
+
+bool next_line(const char **pos, const char *end, const char **line,
+                size_t *len)
+{
+        if (*pos == NULL || *pos >= end)
+                return false;
+
+        const char *nl = memchr(*pos, '\n', end - *pos);
+
+        *line = *pos;
+        *len = (nl ? nl : end) - *pos;
+        *pos = nl ? nl + 1 : end;
+
+        return true;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file mapfile.h
+ * @brief Interface for read-only memory-mapped files.
+ *
+ * Files are mapped as a whole and walked line by line without copying,
+ * so lines are exposed as (pointer, length) views into the mapping.
+ *
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#ifndef MAPFILE_H
+#define MAPFILE_H
+
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "error.h"
+
+/**
+ * @brief Type definition for a mapped file.
+ */
+typedef struct MapFile_tag {
+        const char *data; ///< Pointer to the first byte, or NULL if empty.
+        size_t     size; ///< Size of the mapping in bytes.
+} MapFile;
+
+/**
+ * @brief Maps file into memory.
+ *
+ * Maps the file specified by @p path read-only into memory and stores
+ * the mapping into @p map. An empty file gives an empty mapping with
+ * data set to NULL. Mapping must be released with unmap_file().
+ *
+ * @param[in] path Read-only string with the file name.
+ * @param[in,out] map Pointer to the mapping, which is to be set.
+ * @return True on success, or false otherwise.
+ */
+bool map_file(const char *path, MapFile *map);
+
+/**
+ * @brief Unmaps file from memory.
+ *
+ * @param[in,out] map Pointer to the mapping, which is to be released.
+ * @return Nothing.
+ */
+void unmap_file(MapFile *map);
+
+/**
+ * @brief Gets next line of the mapping.
+ *
+ * Takes position specified by @p pos and stores the line starting there
+ * into @p line and @p len. Line terminator is not included into the
+ * length. @p pos is moved past the line.
+ *
+ * @param[in,out] pos Pointer to the current position in the mapping.
+ * @param[in] end Pointer to the first byte after the mapping.
+ * @param[in,out] line Pointer, where the line start is to be stored.
+ * @param[in,out] len Pointer, where the line length is to be stored.
+ * @return True if a line was found, or false at the end of the mapping.
+ */
+bool next_line(const char **pos, const char *end, const char **line,
+                size_t *len);
+
+#endif
@@ -0,0 +1,379 @@
+/**
+ * @file scan.c
+ * @brief Function definitions for the parallel history scan.
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "archive.h"
+#include "date.h"
+#include "error.h"
+#include "lines.h"
+#include "mapfile.h"
+#include "scan.h"
+
+/**
+ * @brief Type definition for the scan work item.
+ */
+typedef struct ScanItem_tag {
+        const Archive *archive; ///< Archive of the block, or NULL.
+        ArchiveBlock  block; ///< Block, if @p archive isn't NULL.
+        const char    *data; ///< Chunk of a segment file, or unpacked block.
+        size_t        size; ///< Size of @p data in bytes.
+        char          *raw; ///< Buffer of the unpacked block, or NULL.
+        TaskView      *views; ///< Kept tasks.
+        long          nviews; ///< Number of kept tasks.
+        bool          ok; ///< False if the item failed.
+        bool          done; ///< True when the item is parsed.
+} ScanItem;
+
+/**
+ * @brief Type definition for the state of a scan.
+ */
+typedef struct Scan_tag {
+        ScanItem        *items; ///< Work items in history order.
+        long            nitems; ///< Number of items.
+        long            capacity; ///< Number of items the array can hold.
+        Archive         *archives; ///< Open archives of the segments.
+        MapFile         *segments; ///< Mapped segment files.
+        long            nsegs; ///< Number of opened segments.
+        long            next; ///< Index of the next item to be parsed.
+        long            merged; ///< Number of merged items.
+        long            ahead; ///< Items which may be parsed ahead.
+        ScanFilter      filter; ///< Filter of the tasks.
+        const void      *filter_arg; ///< Argument of the filter.
+        pthread_mutex_t lock; ///< Guards @p next, @p merged and item states.
+        pthread_cond_t  parsed; ///< Signalled when an item is parsed.
+        pthread_cond_t  room; ///< Signalled when an item is merged.
+} Scan;
+
+/**
+ * @brief Opens segments of the range and splits them into items.
+ * @param[in,out] scan Pointer to the scan.
+ * @param[in] man Pointer to the read-only manifest.
+ * @param[in] from First date of the range.
+ * @param[in] to Last date of the range.
+ * @return True on success, or false otherwise.
+ */
+static bool plan_scan(Scan *scan, const Manifest *man, Date from, Date to);
+
+/**
+ * @brief Adds empty item to the scan.
+ * @param[in,out] scan Pointer to the scan.
+ * @return Pointer to the item, or NULL on failure.
+ */
+static ScanItem *add_item(Scan *scan);
+
+/**
+ * @brief Unpacks and parses item.
+ * @param[in] scan Pointer to the read-only scan.
+ * @param[in,out] item Pointer to the item.
+ * @return Nothing.
+ */
+static void parse_item(const Scan *scan, ScanItem *item);
+
+/**
+ * @brief Releases buffers of the item.
+ * @param[in,out] item Pointer to the item.
+ * @return Nothing.
+ */
+static void free_item(ScanItem *item);
+
+/**
+ * @brief Parses items until there are none left.
+ * @param[in,out] arg Pointer to the scan.
+ * @return NULL.
+ */
+static void *worker(void *arg);
+
+/**
+ * @brief Gets number of worker threads for a number of items.
+ */
+static long count_workers(long nitems);
+
+bool scan_history(const Manifest *man, Date from, Date to, ScanFilter filter,
+                const void *filter_arg, ScanEmit emit, void *emit_arg)
+{
+        if (man == NULL || filter == NULL || emit == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> NULL pointer.");
+                return false;
+        }
+
+        Scan scan;
+
+        memset(&scan, 0, sizeof(scan));
+        scan.filter = filter;
+        scan.filter_arg = filter_arg;
+
+        bool ok = plan_scan(&scan, man, from, to);
+        long nworkers = ok ? count_workers(scan.nitems) : 0;
+        pthread_t threads[SCAN_MAX_THREADS];
+        long started = 0;
+
+        scan.ahead = nworkers * SCAN_AHEAD;
+        pthread_mutex_init(&scan.lock, NULL);
+        pthread_cond_init(&scan.parsed, NULL);
+        pthread_cond_init(&scan.room, NULL);
+
+        /* One item or one core isn't worth a thread. */
+        while (nworkers > 1 && started < nworkers &&
+                        pthread_create(&threads[started], NULL, worker,
+                                &scan) == 0)
+                ++started;
+
+        for (long i = 0; ok && i < scan.nitems; i++) {
+                ScanItem *item = &scan.items[i];
+
+                if (started == 0) {
+                        parse_item(&scan, item);
+                } else {
+                        pthread_mutex_lock(&scan.lock);
+                        while (!item->done)
+                                pthread_cond_wait(&scan.parsed, &scan.lock);
+                        pthread_mutex_unlock(&scan.lock);
+                }
+
+                if (!item->ok)
+                        ok = false;
+
+                for (long j = 0; ok && j < item->nviews; j++)
+                        emit(&item->views[j], emit_arg);
+
+                free_item(item);
+
+                pthread_mutex_lock(&scan.lock);
+                ++scan.merged;
+                pthread_cond_broadcast(&scan.room);
+                pthread_mutex_unlock(&scan.lock);
+        }
+
+        /* Failed merge lets workers run out of items without a limit. */
+        pthread_mutex_lock(&scan.lock);
+        scan.merged = scan.nitems;
+        pthread_cond_broadcast(&scan.room);
+        pthread_mutex_unlock(&scan.lock);
+
+        for (long i = 0; i < started; i++)
+                pthread_join(threads[i], NULL);
+
+        for (long i = 0; i < scan.nitems; i++)
+                free_item(&scan.items[i]);
+
+        for (long i = 0; i < scan.nsegs; i++) {
+                archive_close(&scan.archives[i]);
+                unmap_file(&scan.segments[i]);
+        }
+
+        pthread_cond_destroy(&scan.room);
+        pthread_cond_destroy(&scan.parsed);
+        pthread_mutex_destroy(&scan.lock);
+        free(scan.items);
+        free(scan.archives);
+        free(scan.segments);
+
+        if (!ok)
+                WARNING("Failed to scan history.");
+
+        return ok;
+}
+
+static bool plan_scan(Scan *scan, const Manifest *man, Date from, Date to)
+{
+        scan->archives = calloc(man->size ? man->size : 1, sizeof(Archive));
+        scan->segments = calloc(man->size ? man->size : 1, sizeof(MapFile));
+
+        if (scan->archives == NULL || scan->segments == NULL) {
+                FAIL(ERR_NOMEM, "Out of memory.");
+                return false;
+        }
+
+        for (long i = 0; i < man->size; i++) {
+                Date month = man->segs[i].month;
+                char path[SEGMENT_PATHSIZE] = { 0 };
+                Archive *archive = &scan->archives[scan->nsegs];
+                MapFile *segment = &scan->segments[scan->nsegs];
+
+                if (month < DATE_MONTH_KEY(from) || month > to)
+                        continue;
+
+                if (!archive_open(month, archive))
+                        return false;
+
+                ++scan->nsegs;
+                segment_path(month, SEGMENT_TEXT, path);
+
+                if (!map_file(path, segment) && errno != ENOENT) {
+                        FAIL(ERR_IO, "Failed to map history segment.");
+                        return false;
+                }
+
+                /* Archived lines go first, lines saved later follow. */
+                for (uint32_t b = 0; b < archive->hdr.blocks; b++) {
+                        ArchiveBlock block;
+
+                        archive_block(archive, b, &block);
+
+                        if (to < block.first || from > block.last)
+                                continue;
+
+                        ScanItem *item = add_item(scan);
+
+                        if (item == NULL)
+                                return false;
+
+                        item->archive = archive;
+                        item->block = block;
+                }
+
+                size_t start = 0;
+
+                while (start < segment->size) {
+                        size_t end = start + SCAN_CHUNK;
+                        const char *nl = NULL;
+
+                        if (end >= segment->size)
+                                end = segment->size;
+                        else if ((nl = memchr(segment->data + end, '\n',
+                                                        segment->size - end)))
+                                end = nl - segment->data + 1;
+                        else
+                                end = segment->size;
+
+                        ScanItem *item = add_item(scan);
+
+                        if (item == NULL)
+                                return false;
+
+                        item->data = segment->data + start;
+                        item->size = end - start;
+                        start = end;
+                }
+        }
+
+        return true;
+}
+
+static ScanItem *add_item(Scan *scan)
+{
+        if (scan->nitems == scan->capacity) {
+                long capacity = scan->capacity ? scan->capacity * 2 : 64;
+                ScanItem *items = realloc(scan->items,
+                                capacity * sizeof(ScanItem));
+
+                if (items == NULL) {
+                        FAIL(ERR_NOMEM, "Out of memory.");
+                        return NULL;
+                }
+
+                scan->items = items;
+                scan->capacity = capacity;
+        }
+
+        ScanItem *item = &scan->items[scan->nitems++];
+
+        memset(item, 0, sizeof(ScanItem));
+        return item;
+}
+
+static void parse_item(const Scan *scan, ScanItem *item)
+{
+        if (item->archive != NULL) {
+                item->raw = malloc(item->block.raw_len ?
+                                item->block.raw_len : 1);
+
+                if (item->raw == NULL || !archive_unpack(item->archive,
+                                        &item->block, item->raw))
+                        return;
+
+                item->data = item->raw;
+                item->size = item->block.raw_len;
+        }
+
+        const char *pos = item->data;
+        const char *end = item->data + item->size;
+        LineBatch batch;
+        TaskView batch_views[LINES_BATCH];
+        bool valid[LINES_BATCH];
+        long capacity = 0;
+
+        while (lines_split(&pos, end, &batch) > 0) {
+                lines_views(&batch, batch_views, valid);
+
+                for (size_t i = 0; i < batch.count; i++) {
+                        TaskView view = batch_views[i];
+
+                        if (!valid[i] || !scan->filter(&view,
+                                                scan->filter_arg))
+                                continue;
+
+                        if (item->nviews == capacity) {
+                                capacity = capacity ? capacity * 2 : 64;
+                                TaskView *views = realloc(item->views,
+                                                capacity * sizeof(TaskView));
+
+                                if (views == NULL)
+                                        return;
+
+                                item->views = views;
+                        }
+
+                        item->views[item->nviews++] = view;
+                }
+        }
+
+        item->ok = true;
+}
+
+static void free_item(ScanItem *item)
+{
+        free(item->raw);
+        item->raw = NULL;
+        free(item->views);
+        item->views = NULL;
+        item->nviews = 0;
+}
+
+static void *worker(void *arg)
+{
+        Scan *scan = arg;
+
+        pthread_mutex_lock(&scan->lock);
+
+        while (scan->next < scan->nitems) {
+                if (scan->next >= scan->merged + scan->ahead) {
+                        pthread_cond_wait(&scan->room, &scan->lock);
+                        continue;
+                }
+
+                ScanItem *item = &scan->items[scan->next++];
+
+                pthread_mutex_unlock(&scan->lock);
+                parse_item(scan, item);
+                pthread_mutex_lock(&scan->lock);
+
+                item->done = true;
+                pthread_cond_broadcast(&scan->parsed);
+        }
+
+        pthread_mutex_unlock(&scan->lock);
+        return NULL;
+}
+
+static long count_workers(long nitems)
+{
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+
+        if (cores < 1)
+                cores = 1;
+
+        if (cores > SCAN_MAX_THREADS)
+                cores = SCAN_MAX_THREADS;
+
+        return nitems < cores ? nitems : cores;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file scan.h
+ * @brief Interface for the parallel history scan.
+ *
+ * Scan splits the history of a date range into work items: archive blocks
+ * which may hold dates of the range, and line-aligned chunks of segment
+ * files. Worker threads, one per available core, unpack and parse the
+ * items and keep the tasks which pass the filter. The calling thread
+ * merges the items back in history order, so the tasks come out exactly
+ * as a sequential pass would give them. Workers run at most a few items
+ * ahead of the merge, which bounds the memory held by parsed items.
+ *
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#ifndef SCAN_H
+#define SCAN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "history.h"
+#include "types.h"
+
+/** Size of the segment file chunk parsed as one item. */
+#define SCAN_CHUNK       (1 << 20)
+
+/** Maximum number of worker threads. */
+#define SCAN_MAX_THREADS 16
+
+/** Number of items per worker which may be parsed ahead of the merge. */
+#define SCAN_AHEAD       4
+
+/**
+ * @brief Filter, which decides if a parsed task is kept.
+ *
+ * Runs on worker threads, so it must not change shared state.
+ */
+typedef bool (*ScanFilter)(const TaskView *view, const void *arg);
+
+/**
+ * @brief Callback, which gets kept tasks in history order.
+ *
+ * Runs on the calling thread only.
+ */
+typedef void (*ScanEmit)(const TaskView *view, void *arg);
+
+/**
+ * @brief Scans history in parallel.
+ *
+ * Parses the history lines of the segments listed in @p man which may
+ * hold dates from @p from to @p to inclusive, passes every valid task to
+ * @p filter and gives the kept ones to @p emit in history order. Blocks
+ * and chunks are picked by the range, so @p filter must check the dates
+ * itself. Views are valid only during the call of @p emit.
+ *
+ * @param[in] man Pointer to the read-only manifest.
+ * @param[in] from First date of the range.
+ * @param[in] to Last date of the range.
+ * @param[in] filter Filter of the tasks.
+ * @param[in] filter_arg Read-only argument of @p filter.
+ * @param[in] emit Callback for the kept tasks.
+ * @param[in,out] emit_arg Argument of @p emit.
+ * @return True on success, or false otherwise.
+ */
+bool scan_history(const Manifest *man, Date from, Date to, ScanFilter filter,
+                const void *filter_arg, ScanEmit emit, void *emit_arg);
+
+#endif
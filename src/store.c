@@ -0,0 +1,379 @@
+/**
+ * @file store.c
+ * @brief Function definitions for crash-safe persistence of the entry.
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#include "store.h"
+
+/**
+ * @brief Syncs directory which contains the file.
+ * @param[in] path Read-only string with the file name.
+ * @return True on success, or false otherwise.
+ */
+static bool sync_dir(const char *path);
+
+/**
+ * @brief Serializes entry in the text format.
+ * @param[in] entry Pointer to the read-only task list.
+ * @param[in,out] len Pointer, where the length is to be stored.
+ * @return Pointer to the buffer on success, or NULL otherwise.
+ */
+static char *serialize_text(const Tasks *entry, size_t *len);
+
+/**
+ * @brief Serializes entry in the binary format.
+ * @param[in] entry Pointer to the read-only task list.
+ * @param[in,out] len Pointer, where the length is to be stored.
+ * @return Pointer to the buffer on success, or NULL otherwise.
+ */
+static char *serialize_binary(const Tasks *entry, size_t *len);
+
+/**
+ * @brief Reads binary entry from the mapping.
+ * @param[in] map Pointer to the read-only mapping of the entry file.
+ * @param[in,out] entry Pointer to the task list.
+ * @return True on success, or false if the file is damaged.
+ */
+static bool read_binary(const MapFile *map, Tasks *entry);
+
+EntryFormat entry_format(const char *path)
+{
+        char magic[sizeof(((EntryHdr *) 0)->magic)] = { 0 };
+        FILE *fp = fopen(path, "rb");
+
+        if (fp == NULL)
+                return ENTRY_TEXT;
+
+        size_t n = fread(magic, 1, sizeof(magic), fp);
+
+        fclose(fp);
+        fp = NULL;
+
+        return n == sizeof(magic) && memcmp(magic, ENTRY_MAGIC,
+                        sizeof(magic)) == 0 ? ENTRY_BINARY : ENTRY_TEXT;
+}
+
+bool read_entry(const char *path, Tasks *entry)
+{
+        if (path == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> path == NULL.");
+                return false;
+        }
+
+        if (entry == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> entry == NULL.");
+                return false;
+        }
+
+        if (entry_format(path) == ENTRY_BINARY) {
+                MapFile map = { NULL, 0 };
+
+                if (!map_file(path, &map)) {
+                        FAIL(ERR_IO, "Failed to map entry file.");
+                        return false;
+                }
+
+                bool ok = read_binary(&map, entry);
+
+                unmap_file(&map);
+
+                if (!ok)
+                        FAIL(ERR_FORMAT, "Entry file is damaged.");
+
+                return ok;
+        }
+
+        FILE *fp = fopen(path, "r");
+
+        if (fp == NULL)
+                return errno == ENOENT;
+
+        bool ok = file_is_empty(fp) || read_entry_from_file(fp, entry);
+
+        fclose(fp);
+        fp = NULL;
+        return ok;
+}
+
+char *serialize_entry(const Tasks *entry, EntryFormat format, size_t *len)
+{
+        if (entry == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> entry == NULL.");
+                return NULL;
+        }
+
+        if (len == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> len == NULL.");
+                return NULL;
+        }
+
+        return format == ENTRY_BINARY ? serialize_binary(entry, len) :
+                serialize_text(entry, len);
+}
+
+bool store_file(const char *path, const char *data, size_t len)
+{
+        if (path == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> path == NULL.");
+                return false;
+        }
+
+        if (data == NULL && len > 0) {
+                FAIL(ERR_PARAM, "Bad parameter -> data == NULL.");
+                return false;
+        }
+
+        size_t path_len = strlen(path);
+        char *tmp_path = malloc(path_len + sizeof(STORE_TMP_SUFFIX));
+
+        if (tmp_path == NULL) {
+                FAIL(ERR_NOMEM, "Out of memory.");
+                return false;
+        }
+
+        memcpy(tmp_path, path, path_len);
+        memcpy(tmp_path + path_len, STORE_TMP_SUFFIX,
+                        sizeof(STORE_TMP_SUFFIX));
+
+        int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+        if (fd < 0) {
+                FAIL(ERR_IO, "Failed to create temporary file.");
+                free(tmp_path);
+                return false;
+        }
+
+        if (!store_write(fd, data, len)) {
+                FAIL(ERR_IO, "Failed to write temporary file.");
+                goto fail;
+        }
+
+        if (fsync(fd) < 0) {
+                FAIL(ERR_IO, "Failed to sync temporary file.");
+                goto fail;
+        }
+
+        if (close(fd) < 0) {
+                fd = -1;
+                FAIL(ERR_IO, "Failed to close temporary file.");
+                goto fail;
+        }
+
+        fd = -1;
+
+        if (rename(tmp_path, path) < 0) {
+                FAIL(ERR_IO, "Failed to replace file.");
+                goto fail;
+        }
+
+        free(tmp_path);
+        tmp_path = NULL;
+        return sync_dir(path);
+
+fail:
+        if (fd >= 0)
+                close(fd);
+        unlink(tmp_path);
+        free(tmp_path);
+        tmp_path = NULL;
+        return false;
+}
+
+bool store_write(int fd, const char *data, size_t len)
+{
+        while (len > 0) {
+                ssize_t n = write(fd, data, len);
+
+                if (n < 0 && errno == EINTR)
+                        continue;
+
+                if (n < 0)
+                        return false;
+
+                data += n;
+                len -= n;
+        }
+
+        return true;
+}
+
+uint64_t store_hash(const char *data, size_t len)
+{
+        uint64_t hash = UINT64_C(14695981039346656037);
+
+        for (size_t i = 0; i < len; i++) {
+                hash ^= (unsigned char) data[i];
+                hash *= UINT64_C(1099511628211);
+        }
+
+        return hash;
+}
+
+bool store_entry(const char *path, const Tasks *entry, EntryFormat format)
+{
+        size_t len = 0;
+        char *buf = serialize_entry(entry, format, &len);
+
+        if (buf == NULL)
+                return false;
+
+        bool ok = store_file(path, buf, len);
+
+        free(buf);
+        buf = NULL;
+        return ok;
+}
+
+static bool sync_dir(const char *path)
+{
+        const char *slash = strrchr(path, '/');
+        char *dir = NULL;
+
+        if (slash == NULL)
+                dir = strdup(".");
+        else if (slash == path)
+                dir = strdup("/");
+        else
+                dir = strndup(path, slash - path);
+
+        if (dir == NULL) {
+                FAIL(ERR_NOMEM, "Out of memory.");
+                return false;
+        }
+
+        int fd = open(dir, O_RDONLY);
+
+        free(dir);
+        dir = NULL;
+
+        if (fd < 0)
+                return false;
+
+        bool ok = fsync(fd) == 0;
+
+        close(fd);
+        return ok;
+}
+
+static char *serialize_text(const Tasks *entry, size_t *len)
+{
+        /* Every line is "dd.mm.yyyy s subject\n". */
+        size_t size = 1;
+
+        for (long i = 1; i <= tasks_size(entry); i++)
+                size += SUBJOFFSET + strlen(task_subject(entry, i)) + 1;
+
+        char *buf = malloc(size);
+
+        if (buf == NULL) {
+                FAIL(ERR_NOMEM, "Out of memory.");
+                return NULL;
+        }
+
+        char *pos = buf;
+
+        for (long i = 1; i <= tasks_size(entry); i++) {
+                const char *subject = task_subject(entry, i);
+                size_t subj_len = strlen(subject);
+
+                date_to_str(task_date(entry, i), pos);
+                pos[DATEOFFSET] = ' ';
+                pos[STATOFFSET] = task_status(entry, i) ? '+' : '-';
+                pos[STATOFFSET + 1] = ' ';
+                memcpy(pos + SUBJOFFSET, subject, subj_len);
+                pos += SUBJOFFSET + subj_len;
+                *pos++ = '\n';
+        }
+
+        *pos = '\0';
+        *len = pos - buf;
+        return buf;
+}
+
+static char *serialize_binary(const Tasks *entry, size_t *len)
+{
+        EntryHdr hdr = { { 0 }, ENTRY_VERSION, entry->size, 0 };
+
+        memcpy(hdr.magic, ENTRY_MAGIC, sizeof(hdr.magic));
+
+        for (long i = 1; i <= tasks_size(entry); i++) {
+                size_t subj_len = strlen(task_subject(entry, i));
+
+                if (subj_len > ENTRY_SUBJMAX) {
+                        FAIL(ERR_FORMAT, "Subject is too long.");
+                        return NULL;
+                }
+
+                hdr.subj_size += subj_len + 1;
+        }
+
+        size_t size = sizeof(EntryHdr) + entry->size * sizeof(EntryRec) +
+                hdr.subj_size;
+        char *buf = malloc(size);
+
+        if (buf == NULL) {
+                FAIL(ERR_NOMEM, "Out of memory.");
+                return NULL;
+        }
+
+        EntryRec *recs = (EntryRec *) (buf + sizeof(EntryHdr));
+        char *subj = (char *) (recs + entry->size);
+
+        memcpy(buf, &hdr, sizeof(EntryHdr));
+
+        for (long i = 1; i <= tasks_size(entry); i++) {
+                size_t subj_len = strlen(task_subject(entry, i));
+                EntryRec rec = { task_date(entry, i), subj_len,
+                        task_status(entry, i), 0 };
+
+                memcpy(&recs[i - 1], &rec, sizeof(EntryRec));
+                memcpy(subj, task_subject(entry, i), subj_len + 1);
+                subj += subj_len + 1;
+        }
+
+        *len = size;
+        return buf;
+}
+
+static bool read_binary(const MapFile *map, Tasks *entry)
+{
+        EntryHdr hdr;
+
+        if (map->size < sizeof(EntryHdr))
+                return false;
+
+        memcpy(&hdr, map->data, sizeof(EntryHdr));
+
+        if (memcmp(hdr.magic, ENTRY_MAGIC, sizeof(hdr.magic)) != 0 ||
+                        hdr.version != ENTRY_VERSION ||
+                        map->size != sizeof(EntryHdr) + (size_t) hdr.count *
+                        sizeof(EntryRec) + hdr.subj_size)
+                return false;
+
+        if (!reserve_tasks(entry, hdr.count, hdr.subj_size))
+                return false;
+
+        const char *recs = map->data + sizeof(EntryHdr);
+        const char *subj = recs + (size_t) hdr.count * sizeof(EntryRec);
+        const char *end = map->data + map->size;
+
+        for (uint32_t i = 0; i < hdr.count; i++) {
+                EntryRec rec;
+
+                memcpy(&rec, recs + i * sizeof(EntryRec), sizeof(EntryRec));
+
+                /* Subject must fit the file and end with its zero. */
+                if ((size_t) (end - subj) <= rec.subj_len ||
+                                subj[rec.subj_len] != '\0')
+                        return false;
+
+                if (!add_dated_task(entry, rec.date, subj, rec.status))
+                        return false;
+
+                subj += rec.subj_len + 1;
+        }
+
+        return true;
+}
@@ -0,0 +1,171 @@
+/**
+ * @file store.h
+ * @brief Interface for crash-safe persistence of the entry.
+ *
+ * Entry is serialized into one buffer and written to a temporary file
+ * next to the target with a single write(). The temporary file is synced
+ * and then renamed over the target, so the target always holds either
+ * the old or the new entry, never a half-written one.
+ *
+ * Entry is kept either in the text format or in the binary one. Binary
+ * file starts with EntryHdr, followed by one EntryRec per task and then
+ * by the subjects, each one taking subj_len bytes plus a terminating zero.
+ * Numbers are stored in the host byte order. Binary file is loaded
+ * without parsing: subjects are used right from the mapping.
+ *
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#ifndef STORE_H
+#define STORE_H
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "date.h"
+#include "error.h"
+#include "mapfile.h"
+#include "tasks.h"
+#include "types.h"
+
+/** Suffix of the temporary file used while saving. */
+#define STORE_TMP_SUFFIX ".tmp"
+
+/** Magic bytes at the start of the binary entry file. */
+#define ENTRY_MAGIC   "DENT"
+
+/** Version of the binary entry file layout. */
+#define ENTRY_VERSION 1
+
+/** Maximum length of a subject the binary entry file can hold. */
+#define ENTRY_SUBJMAX UINT16_MAX
+
+/**
+ * @brief Type definition for the binary entry file header.
+ */
+typedef struct EntryHdr_tag {
+        char     magic[4]; ///< ENTRY_MAGIC.
+        uint32_t version; ///< ENTRY_VERSION.
+        uint32_t count; ///< Number of tasks.
+        uint32_t subj_size; ///< Size of the subjects area in bytes.
+} EntryHdr;
+
+/**
+ * @brief Type definition for the binary entry record.
+ */
+typedef struct EntryRec_tag {
+        Date     date; ///< Task date.
+        uint16_t subj_len; ///< Length of the subject without the zero.
+        uint8_t  status; ///< 1 for a done task, 0 otherwise.
+        uint8_t  reserved; ///< Always 0.
+} EntryRec;
+
+/**
+ * @brief Type definition for the entry file format.
+ */
+typedef enum EntryFormat_tag {
+        ENTRY_TEXT, ///< Lines in the dd.mm.yyyy s subject form.
+        ENTRY_BINARY ///< EntryHdr, records and subjects.
+} EntryFormat;
+
+/**
+ * @brief Detects entry file format.
+ *
+ * Checks the magic bytes of the file specified by @p path. Missing or
+ * empty file is treated as a text one.
+ *
+ * @param[in] path Read-only string with the file name.
+ * @return Format of the file.
+ */
+EntryFormat entry_format(const char *path);
+
+/**
+ * @brief Reads entry.
+ *
+ * Reads the file specified by @p path in any format into the list
+ * specified by @p entry, keeping task dates. Missing file gives an empty
+ * list.
+ *
+ * @param[in] path Read-only string with the file name.
+ * @param[in,out] entry Pointer to the task list.
+ * @return True on success, or false otherwise.
+ */
+bool read_entry(const char *path, Tasks *entry);
+
+/**
+ * @brief Serializes entry.
+ *
+ * Renders the task list specified by @p entry in the format specified by
+ * @p format into one newly allocated buffer. It's responsibility of the
+ * caller to free the buffer.
+ *
+ * @param[in] entry Pointer to the read-only task list.
+ * @param[in] format Format of the output.
+ * @param[in,out] len Pointer, where the length of the buffer is to be
+ *                stored.
+ * @return Pointer to the buffer on success, or NULL otherwise.
+ */
+char *serialize_entry(const Tasks *entry, EntryFormat format, size_t *len);
+
+/**
+ * @brief Atomically replaces file content.
+ *
+ * Writes @p len bytes of @p data into a temporary file next to @p path,
+ * syncs it and renames it over @p path. The directory is synced too, so
+ * the rename survives a crash.
+ *
+ * @param[in] path Read-only string with the file name.
+ * @param[in] data Bytes to be written.
+ * @param[in] len Number of bytes.
+ * @return True on success, or false otherwise.
+ */
+bool store_file(const char *path, const char *data, size_t len);
+
+/**
+ * @brief Writes whole buffer.
+ *
+ * Calls write() until all @p len bytes of @p data are written, retrying
+ * when interrupted by a signal.
+ *
+ * @param[in] fd File descriptor.
+ * @param[in] data Bytes to be written.
+ * @param[in] len Number of bytes.
+ * @return True on success, or false otherwise.
+ */
+bool store_write(int fd, const char *data, size_t len);
+
+/**
+ * @brief Hashes bytes.
+ *
+ * Computes 64-bit FNV-1a hash of @p len bytes of @p data. Used to tell
+ * whether a file is the one a journal or an archive was made from.
+ *
+ * @param[in] data Bytes to be hashed, may be NULL if @p len is 0.
+ * @param[in] len Number of bytes.
+ * @return Hash value.
+ */
+uint64_t store_hash(const char *data, size_t len);
+
+/**
+ * @brief Atomically saves entry.
+ *
+ * Serializes the task list specified by @p entry in the format specified
+ * by @p format and stores it into the file specified by @p path with
+ * store_file().
+ *
+ * @param[in] path Read-only string with the file name.
+ * @param[in] entry Pointer to the read-only task list.
+ * @param[in] format Format of the file.
+ * @return True on success, or false otherwise.
+ */
+bool store_entry(const char *path, const Tasks *entry, EntryFormat format);
+
+#endif
@@ -0,0 +1,259 @@
+/**
+ * @file summary.c
+ * @brief Function definitions for per-segment history summaries.
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "archive.h"
+#include "date.h"
+#include "error.h"
+#include "scan.h"
+#include "store.h"
+#include "summary.h"
+
+/**
+ * @brief Gets sizes of the sources the summary is counted from.
+ * @param[in] month Month key of the segment.
+ * @param[in,out] hdr Header, where the sizes are to be stored.
+ * @return Nothing.
+ */
+static void source_sizes(Date month, SummaryHdr *hdr);
+
+/**
+ * @brief Checks if task belongs to the month.
+ * @param[in] view Pointer to the read-only task.
+ * @param[in] arg Pointer to the read-only month key.
+ * @return True if the task belongs to the month, or false otherwise.
+ */
+static bool in_month(const TaskView *view, const void *arg);
+
+/**
+ * @brief Counts task into its day.
+ * @param[in] view Pointer to the read-only task.
+ * @param[in,out] arg Array of SUMMARY_DAYS day counts.
+ * @return Nothing.
+ */
+static void count_task(const TaskView *view, void *arg);
+
+/**
+ * @brief Rebuilds the summary from the segment.
+ * @param[in] month Month key of the segment.
+ * @param[in] hdr Read-only header with the source sizes.
+ * @return True on success, or false otherwise.
+ */
+static bool rebuild_summary(Date month, const SummaryHdr *hdr);
+
+/**
+ * @brief Gets the first date of the period a date belongs to.
+ */
+static Date period_key(Date date, Period period);
+
+bool summary_sync(Date month)
+{
+        char path[SEGMENT_PATHSIZE] = { 0 };
+        SummaryHdr actual;
+        SummaryHdr hdr;
+
+        source_sizes(month, &actual);
+        segment_path(month, SEGMENT_SUMMARY, path);
+
+        FILE *fp = fopen(path, "rb");
+
+        if (fp != NULL) {
+                bool fresh = fread(&hdr, sizeof(SummaryHdr), 1, fp) == 1 &&
+                        memcmp(hdr.magic, SUMMARY_MAGIC,
+                                        sizeof(hdr.magic)) == 0 &&
+                        hdr.version == SUMMARY_VERSION &&
+                        hdr.seg_size == actual.seg_size &&
+                        hdr.raw_size == actual.raw_size;
+
+                fclose(fp);
+                fp = NULL;
+
+                if (fresh)
+                        return true;
+        }
+
+        return rebuild_summary(month, &actual);
+}
+
+bool summary_read(Date month, Stats *days)
+{
+        if (days == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> days == NULL.");
+                return false;
+        }
+
+        if (!summary_sync(month))
+                return false;
+
+        char path[SEGMENT_PATHSIZE] = { 0 };
+
+        segment_path(month, SEGMENT_SUMMARY, path);
+
+        FILE *fp = fopen(path, "rb");
+        bool ok = fp != NULL &&
+                fseek(fp, sizeof(SummaryHdr), SEEK_SET) == 0 &&
+                fread(days, sizeof(Stats), SUMMARY_DAYS, fp) == SUMMARY_DAYS;
+
+        if (!ok)
+                WARNING("Failed to read history summary.");
+
+        if (fp != NULL)
+                fclose(fp);
+
+        return ok;
+}
+
+long summary_stats(const Manifest *man, Date from, Date to, Period period,
+                PeriodStats **rows)
+{
+        if (man == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> man == NULL.");
+                return -1;
+        }
+
+        if (rows == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> rows == NULL.");
+                return -1;
+        }
+
+        *rows = NULL;
+
+        long count = 0;
+        long capacity = 0;
+
+        /* Segments and their days come in date order, so do periods. */
+        for (long i = 0; i < man->size; i++) {
+                Date month = man->segs[i].month;
+                Stats days[SUMMARY_DAYS];
+
+                if (month < DATE_MONTH_KEY(from) || month > to)
+                        continue;
+
+                if (!summary_read(month, days)) {
+                        free(*rows);
+                        *rows = NULL;
+                        return -1;
+                }
+
+                for (int day = 1; day <= SUMMARY_DAYS; day++) {
+                        Date date = month | (Date) day;
+                        Stats *stats = &days[day - 1];
+
+                        if (stats->total == 0 || date < from || date > to)
+                                continue;
+
+                        Date key = period_key(date, period);
+
+                        if (count > 0 && (*rows)[count - 1].key == key) {
+                                (*rows)[count - 1].stats.done += stats->done;
+                                (*rows)[count - 1].stats.total +=
+                                        stats->total;
+                                continue;
+                        }
+
+                        if (count == capacity) {
+                                capacity = capacity ? capacity * 2 : 64;
+                                PeriodStats *tmp = realloc(*rows,
+                                                capacity *
+                                                sizeof(PeriodStats));
+
+                                if (tmp == NULL) {
+                                        FAIL(ERR_NOMEM, "Out of memory.");
+                                        free(*rows);
+                                        *rows = NULL;
+                                        return -1;
+                                }
+
+                                *rows = tmp;
+                        }
+
+                        (*rows)[count].key = key;
+                        (*rows)[count].stats = *stats;
+                        ++count;
+                }
+        }
+
+        return count;
+}
+
+static void source_sizes(Date month, SummaryHdr *hdr)
+{
+        char path[SEGMENT_PATHSIZE] = { 0 };
+        struct stat st;
+        ArchiveHdr archive;
+
+        memset(hdr, 0, sizeof(SummaryHdr));
+        memcpy(hdr->magic, SUMMARY_MAGIC, sizeof(hdr->magic));
+        hdr->version = SUMMARY_VERSION;
+
+        segment_path(month, SEGMENT_TEXT, path);
+        hdr->seg_size = stat(path, &st) == 0 ? st.st_size : 0;
+
+        segment_path(month, SEGMENT_ARCHIVE, path);
+
+        FILE *fp = fopen(path, "rb");
+
+        if (fp == NULL)
+                return;
+
+        if (fread(&archive, sizeof(ArchiveHdr), 1, fp) == 1)
+                hdr->raw_size = archive.raw_size;
+
+        fclose(fp);
+}
+
+static bool in_month(const TaskView *view, const void *arg)
+{
+        return DATE_MONTH_KEY(view->date) == *(const Date *) arg;
+}
+
+static void count_task(const TaskView *view, void *arg)
+{
+        Stats *stats = (Stats *) arg + DATE_DAY(view->date) - 1;
+
+        ++stats->total;
+        stats->done += view->status;
+}
+
+static bool rebuild_summary(Date month, const SummaryHdr *hdr)
+{
+        char path[SEGMENT_PATHSIZE] = { 0 };
+        struct {
+                SummaryHdr hdr;
+                Stats      days[SUMMARY_DAYS];
+        } summary;
+        Segment segment = { month, 0 };
+        Manifest man = { &segment, 1, 1, 0 };
+
+        memset(&summary, 0, sizeof(summary));
+        summary.hdr = *hdr;
+
+        if (!scan_history(&man, month | 1, month | SUMMARY_DAYS, in_month,
+                                &month, count_task, summary.days))
+                return false;
+
+        segment_path(month, SEGMENT_SUMMARY, path);
+        return store_file(path, (const char *) &summary, sizeof(summary));
+}
+
+static Date period_key(Date date, Period period)
+{
+        switch (period) {
+                case PERIOD_WEEK:
+                        return date_week_key(date);
+
+                case PERIOD_MONTH:
+                        return DATE_MONTH_KEY(date);
+
+                default:
+                        return date;
+        }
+}
@@ -0,0 +1,111 @@
+/**
+ * @file summary.h
+ * @brief Interface for per-segment history summaries.
+ *
+ * Every history segment has a YYYY-MM.sum file next to it with the number
+ * of done and all tasks for each day of the month. The header keeps the
+ * size of the segment file and the raw size of the archive it was counted
+ * from. Both only grow when lines are added, so summary which doesn't
+ * match them is stale and is counted again. Statistics over long ranges
+ * read one small summary per month instead of parsing history lines.
+ *
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#ifndef SUMMARY_H
+#define SUMMARY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "history.h"
+#include "types.h"
+
+/** Magic bytes at the start of the summary file. */
+#define SUMMARY_MAGIC   "DSUM"
+
+/** Version of the summary file layout. */
+#define SUMMARY_VERSION 1
+
+/** Number of days in the summary, one for each possible day of a month. */
+#define SUMMARY_DAYS    31
+
+/**
+ * @brief Type definition for the summary file header.
+ */
+typedef struct SummaryHdr_tag {
+        char     magic[4]; ///< SUMMARY_MAGIC.
+        uint32_t version; ///< SUMMARY_VERSION.
+        uint64_t seg_size; ///< Size of the segment file.
+        uint64_t raw_size; ///< Raw size of the archive, or 0.
+} SummaryHdr;
+
+/**
+ * @brief Type definition for the task counts.
+ */
+typedef struct Stats_tag {
+        uint32_t done; ///< Number of done tasks.
+        uint32_t total; ///< Number of all tasks.
+} Stats;
+
+/**
+ * @brief Type definition for the period statistics are grouped by.
+ */
+typedef enum Period_tag {
+        PERIOD_DAY, ///< Every day separately.
+        PERIOD_WEEK, ///< Weeks from Monday.
+        PERIOD_MONTH ///< Calendar months.
+} Period;
+
+/**
+ * @brief Type definition for the statistics of one period.
+ */
+typedef struct PeriodStats_tag {
+        Date  key; ///< First date of the period.
+        Stats stats; ///< Task counts of the period.
+} PeriodStats;
+
+/**
+ * @brief Makes sure the summary describes the segment.
+ *
+ * Rebuilds the summary of @p month from its archive and segment file if
+ * it's missing, damaged or stale.
+ *
+ * @param[in] month Month key of the segment.
+ * @return True on success, or false otherwise.
+ */
+bool summary_sync(Date month);
+
+/**
+ * @brief Reads summary.
+ *
+ * Syncs the summary of @p month and stores its day counts into @p days,
+ * which must hold SUMMARY_DAYS elements. Day 1 goes first.
+ *
+ * @param[in] month Month key of the segment.
+ * @param[in,out] days Array, where day counts are to be stored.
+ * @return True on success, or false otherwise.
+ */
+bool summary_read(Date month, Stats *days);
+
+/**
+ * @brief Gathers statistics of a date range.
+ *
+ * Sums day counts from @p from to @p to inclusive, taken from the summaries
+ * of the segments listed in @p man, into periods specified by @p period.
+ * Periods without tasks are left out. Periods are stored in date order
+ * into a newly allocated array. It's responsibility of the caller to free
+ * the array.
+ *
+ * @param[in] man Pointer to the read-only manifest.
+ * @param[in] from First date of the range.
+ * @param[in] to Last date of the range.
+ * @param[in] period Period the counts are grouped by.
+ * @param[in,out] rows Pointer, where the array is to be stored.
+ * @return Number of periods, or -1 on failure.
+ */
+long summary_stats(const Manifest *man, Date from, Date to, Period period,
+                PeriodStats **rows);
+
+#endif
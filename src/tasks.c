@@ -8,359 +8,637 @@
 #include "tasks.h"
 
 /**
- * @brief Makes a string copy.
- * @param[in] src Source string.
- * @param[in] size size_t with the length of the source string.
- * @return Poiner to string copy.
+ * @brief Checks if task index is in the list.
+ * @param[in] entry Pointer to a read-only task list.
+ * @param[in] index Long int with the task index.
+ * @return True if task exists, or false otherwise.
  */
-static char *copy_str(char *src, size_t size);
+static bool has_task(const Tasks *entry, long index);
 
 /**
- * @brief Searches for a task by index.
- * @param[in] entry Pointer to a read-only task list.
- * @param[in] long with the task index.
- * @return Pointer to found task on success, or NULL otherwise.
+ * @brief Sets or clears task status bit.
+ * @param[in,out] entry Pointer to a task list.
+ * @param[in] index Long int with the task index.
+ * @param[in] status Boolean value with the new status.
+ * @return Nothing.
  */
-static Task *find_task(const Tasks *entry, long index);
+static void set_status(Tasks *entry, long index, bool status);
 
 /**
- * @brief Searches for a list element by index.
- * @param[in] entry Pointer to a read-only task list.
- * @param[int] index long with the task index.
- * @return Pointer to found element on success, or NULL otherwise.
+ * @brief Grows task arrays.
+ * @param[in,out] entry Pointer to a task list.
+ * @param[in] capacity Minimal number of tasks the arrays must hold.
+ * @return True on success, or false otherwise.
  */
-static TasksElmt *find_list_elmt(const Tasks *entry, long index);
+static bool grow_tasks(Tasks *entry, long capacity);
 
 /**
- * @brief Extracts task from the list element.
- * @param[in] el Pointer to the list element.
- * @return Pointer to extracted task.
+ * @brief Gets next character of a normalized subject.
+ *
+ * Normalized subject has no leading and trailing spaces, runs of spaces
+ * inside it are one space and letters are lowercase.
+ *
+ * @param[in,out] pos Pointer to the current position.
+ * @param[in] end Pointer to the end of the subject.
+ * @param[in,out] started Pointer to the flag, initially false, which is
+ *                set after the first character.
+ * @return Character, or -1 at the end of the subject.
  */
-static Task *extract_task(TasksElmt *el);
+static int next_norm(const char **pos, const char *end, bool *started);
 
 /**
- * @brief Reindexes tasks in a task list.
- * @param[in,out] entry Pointer to a task list.
- * @return Nothing.
+ * @brief Hashes normalized subject.
+ * @return Hash, never 0.
+ */
+static uint64_t subject_hash(const char *subject, size_t len);
+
+/**
+ * @brief Compares two subjects after normalization.
+ * @return True if they are equal, or false otherwise.
  */
-static void reindex_tasks(Tasks *entry);
+static bool same_subject(const char *a, size_t a_len, const char *b,
+                size_t b_len);
 
-bool add_task(Tasks *entry, char *subject, bool status)
+/**
+ * @brief Finds task with the subject in the hash table.
+ * @param[in] entry Pointer to a read-only task list in the dedup mode.
+ * @param[in] hash Hash of the subject.
+ * @param[in] subject Read-only subject.
+ * @param[in] len Length of the subject.
+ * @param[in] skip Index of a task which is not to be found, or 0.
+ * @return Index of the task, or 0 if there is none.
+ */
+static long hash_find(const Tasks *entry, uint64_t hash, const char *subject,
+                size_t len, long skip);
+
+/**
+ * @brief Makes sure the hash table can take one more task.
+ * @param[in,out] table Pointer to the hash table.
+ * @return True on success, or false otherwise.
+ */
+static bool hash_reserve(TaskHash *table);
+
+/**
+ * @brief Adds task to the hash table, which must have a free slot.
+ */
+static void hash_insert(TaskHash *table, uint64_t hash, long index);
+
+/**
+ * @brief Removes task from the hash table.
+ */
+static void hash_remove(TaskHash *table, uint64_t hash, long index);
+
+/**
+ * @brief Gets number of bitset words for a number of tasks.
+ */
+#define STATUS_WORDS(n) (((n) + TASKS_WORD_BITS - 1) / TASKS_WORD_BITS)
+
+bool add_task(Tasks *entry, const char *subject, bool status)
 {
-        /** Subject parameter can be NULL */
+        Date date = 0;
+
+        get_curr_date(&date);
+        return add_dated_task(entry, date, subject, status);
+}
+
+bool add_dated_task(Tasks *entry, Date date, const char *subject,
+                bool status)
+{
+        if (subject == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> subject == NULL.");
+                return false;
+        }
 
+        return add_dated_task_len(entry, date, subject, strlen(subject),
+                        status);
+}
+
+bool add_dated_task_len(Tasks *entry, Date date, const char *subject,
+                size_t len, bool status)
+{
         if (entry == NULL) {
-                WARNING("Bad parameter -> entry == NULL.");
+                FAIL(ERR_PARAM, "Bad parameter -> entry == NULL.");
+                return false;
+        }
+
+        if (subject == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> subject == NULL.");
                 return false;
         }
 
-        char tmp[SUBJSIZE] = { 0 };
-        char date[DATESIZE] = { 0 };
+        uint64_t hash = 0;
+
+        if (entry->dedup.slots != NULL) {
+                hash = subject_hash(subject, len);
 
-        show_tasks(entry);
-        printf("task: ");
+                if (hash_find(entry, hash, subject, len, 0) != 0)
+                        return true;
 
-        if (!subject) {
-                subject = tmp;
-                if (!get_str(subject, SUBJSIZE, stdin))
+                if (!hash_reserve(&entry->dedup))
                         return false;
         }
 
-        /* Capitalize first letter of the subject. */
-        subject[0] = toupper(subject[0]);
-
-        get_curr_date(date);
+        if (entry->size == entry->capacity &&
+                        !grow_tasks(entry, entry->capacity * 2))
+                return false;
 
-        Task *task = set_task(tasks_size(entry) + 1, date, status, subject);
+        char *copy = arena_strndup(&entry->arena, subject, len);
 
-        if (task == NULL) {
+        if (copy == NULL) {
                 WARNING("Failed to make task.");
                 return false;
         }
 
-        return ins_task_after(entry, tasks_tail(entry), task) == 0;
+        /* Capitalize first letter of the subject. */
+        copy[0] = toupper((unsigned char) copy[0]);
+
+        long index = ++entry->size;
+
+        task_date(entry, index) = date;
+        task_subject(entry, index) = copy;
+        set_status(entry, index, status);
+
+        if (entry->dedup.slots != NULL)
+                hash_insert(&entry->dedup, hash, index);
+
+        char date_str[DATESIZE] = { 0 };
+
+        date_to_str(date, date_str);
+        journal_record(entry->journal, entry, "a %s %c %s", date_str,
+                        status ? '+' : '-', copy);
+        return true;
 }
 
-bool change_task(Tasks *entry, long index)
+bool change_task(Tasks *entry, long index, const char *subject)
 {
         if (entry == NULL) {
-                WARNING("Bad parameter -> entry == NULL.");
+                FAIL(ERR_PARAM, "Bad parameter -> entry == NULL.");
                 return false;
         }
 
-        char subject[SUBJSIZE] = { 0 };
-        char *new_subject = NULL;
+        if (subject == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> subject == NULL.");
+                return false;
+        }
 
-        Task *task = find_task(entry, index);
+        if (!has_task(entry, index))
+                return false;
 
-        if (task != NULL) {
-                free(task->subject);
-                task->subject = NULL;
-                printf("new task: ");
+        size_t len = strlen(subject);
+        uint64_t hash = 0;
 
-                if (get_str(subject, SUBJSIZE, stdin)) {
-                        new_subject = copy_str(subject, strlen(subject) + 1);
+        if (entry->dedup.slots != NULL) {
+                hash = subject_hash(subject, len);
 
-                        if (new_subject != NULL) {
-                                task->subject = new_subject;
-                                return true;
-                        }
+                if (hash_find(entry, hash, subject, len, index) != 0) {
+                        err_set(ERR_PARAM, "Duplicate task.");
+                        return false;
                 }
         }
 
-        return false;
+        char *new_subject = arena_strndup(&entry->arena, subject, len);
+
+        if (new_subject == NULL)
+                return false;
+
+        /* Old subject frees the slot the new one takes. */
+        if (entry->dedup.slots != NULL) {
+                const char *old = task_subject(entry, index);
+
+                hash_remove(&entry->dedup, subject_hash(old, strlen(old)),
+                                index);
+                hash_insert(&entry->dedup, hash, index);
+        }
+
+        task_subject(entry, index) = new_subject;
+        journal_record(entry->journal, entry, "c %ld %s", index, new_subject);
+        return true;
 }
 
 bool do_task(Tasks *entry, long index)
 {
         if (entry == NULL) {
-                WARNING("Bad parameter -> entry == NULL.");
+                FAIL(ERR_PARAM, "Bad parameter -> entry == NULL.");
                 return false;
         }
 
-        TasksElmt *el = find_list_elmt(entry, index);
-
-        if (el != NULL) {
-                Task *task = extract_task(el);
-                check_as_done(task);
+        if (has_task(entry, index)) {
+                set_status(entry, index, DONE);
+                journal_record(entry->journal, entry, "x %ld", index);
                 return true;
         }
 
         return false;
 }
 
-void check_as_done(Task *task)
-{
-        if (task == NULL) {
-                WARNING("Bad parameter -> task == NULL.");
-                return;
-        }
-
-        task->status = DONE;
-}
-
 bool undo_task(Tasks *entry, long index)
 {
         if (entry == NULL) {
-                WARNING("Bad parameter -> entry == NULL.");
+                FAIL(ERR_PARAM, "Bad parameter -> entry == NULL.");
                 return false;
         }
 
-        TasksElmt *el = find_list_elmt(entry, index);
-
-        if (el != NULL) {
-                Task *task = extract_task(el);
-                uncheck_done(task);
+        if (has_task(entry, index)) {
+                set_status(entry, index, UNDONE);
+                journal_record(entry->journal, entry, "u %ld", index);
                 return true;
         }
 
         return false;
 }
 
-void uncheck_done(Task *task)
+void set_all_tasks(Tasks *entry, bool status)
 {
-        if (task == NULL) {
-                WARNING("Bad parameter -> task == NULL.");
+        if (entry == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> entry == NULL.");
                 return;
         }
 
-        task->status = UNDONE;
+        long words = STATUS_WORDS(entry->size);
+
+        if (words > 0) {
+                memset(entry->done, status ? 0xff : 0x00,
+                                words * sizeof(uint64_t));
+
+                /* Keep bits past the last task clear. */
+                long tail = entry->size % TASKS_WORD_BITS;
+
+                if (status && tail != 0)
+                        entry->done[words - 1] &= (UINT64_C(1) << tail) - 1;
+        }
+
+        journal_record(entry->journal, entry, status ? "X" : "U");
 }
 
 bool delete_task(Tasks *entry, long index)
 {
         if (entry == NULL) {
-                WARNING("Bad parameter -> entry == NULL.");
+                FAIL(ERR_PARAM, "Bad parameter -> entry == NULL.");
                 return false;
         }
 
-        TasksElmt *el = find_list_elmt(entry, index);
+        if (!has_task(entry, index))
+                return false;
 
-        if (el != NULL) {
+        if (entry->dedup.slots != NULL) {
+                const char *subject = task_subject(entry, index);
+                TaskHash *table = &entry->dedup;
 
-                Task *task = extract_task(el);
-                destroy_task(task);
+                hash_remove(table, subject_hash(subject, strlen(subject)),
+                                index);
 
-                if (remove_elmt(entry, el, &(el->data)) < 0) {
-                        WARNING("Failed to remove element.");
-                        return false;
-                }
+                /* Tasks after the deleted one move down by one. */
+                for (long i = 0; i < table->capacity; i++)
+                        if (table->slots[i].index > index)
+                                --table->slots[i].index;
+        }
 
-                reindex_tasks(entry);
-                return true;
+        /* Subject belongs to the arena and is not freed here. */
+        long tail = entry->size - index;
+
+        memmove(&task_date(entry, index), &task_date(entry, index + 1),
+                        tail * sizeof(Date));
+        memmove(&task_subject(entry, index), &task_subject(entry, index + 1),
+                        tail * sizeof(char *));
+
+        /* Shift status bits above the deleted one down by one position. */
+        long pos = index - 1;
+        long first = pos / TASKS_WORD_BITS;
+        long words = STATUS_WORDS(entry->size);
+        uint64_t *done = entry->done;
+        uint64_t low = done[first] & ((UINT64_C(1) << (pos % TASKS_WORD_BITS))
+                        - 1);
+
+        done[first] = low | ((done[first] >> 1) &
+                        ~((UINT64_C(1) << (pos % TASKS_WORD_BITS)) - 1));
+
+        for (long i = first; i < words; i++) {
+                if (i > first)
+                        done[i] >>= 1;
+
+                if (i + 1 < words)
+                        done[i] |= done[i + 1] << (TASKS_WORD_BITS - 1);
         }
 
-        return false;
+        --entry->size;
+        journal_record(entry->journal, entry, "d %ld", index);
+        return true;
 }
 
-void traverse_tasks(Tasks *entry, void (*func)(Task *task))
+void init_tasks(Tasks *entry)
 {
         if (entry == NULL) {
-                WARNING("Bad parameter -> entry == NULL.");
+                FAIL(ERR_PARAM, "Bad parameter -> entry == NULL.");
                 return;
         }
 
-        if (func == NULL) {
-                WARNING("Bad parameter -> func == NULL.");
+        entry->dates = NULL;
+        entry->subjects = NULL;
+        entry->done = NULL;
+        entry->size = 0;
+        entry->capacity = 0;
+        entry->dedup.slots = NULL;
+        entry->dedup.capacity = 0;
+        entry->dedup.count = 0;
+        entry->journal = NULL;
+        arena_init(&entry->arena, TASKS_ARENA_BLOCK);
+}
+
+void reset_tasks(Tasks *entry)
+{
+        if (entry == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> entry == NULL.");
                 return;
         }
 
-        for (TasksElmt *el = tasks_head(entry); el != NULL; el = next_elmt(el)) {
-                Task *task = extract_task(el);
+        if (entry->done != NULL)
+                memset(entry->done, 0, STATUS_WORDS(entry->capacity) *
+                                sizeof(uint64_t));
 
-                if (task == NULL) {
-                        WARNING("Failed to extract task.");
-                        return;
-                }
+        if (entry->dedup.slots != NULL)
+                memset(entry->dedup.slots, 0, entry->dedup.capacity *
+                                sizeof(TaskSlot));
 
-                func(task);
+        entry->dedup.count = 0;
+        entry->size = 0;
+        arena_reset(&entry->arena);
+        journal_record(entry->journal, entry, "D");
+}
+
+void destroy_tasks(Tasks *entry)
+{
+        if (entry == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> entry == NULL.");
+                return;
         }
+
+        free(entry->dates);
+        free(entry->subjects);
+        free(entry->done);
+        free(entry->dedup.slots);
+        arena_destroy(&entry->arena);
+        init_tasks(entry);
 }
 
-Task *set_task(long index, char *date, bool status, char *subject)
+bool reserve_tasks(Tasks *entry, long count, size_t subj_size)
 {
-        if (date == NULL) {
-                WARNING("Bad parameter -> date == NULL.");
-                return NULL;
+        if (entry == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> entry == NULL.");
+                return false;
         }
 
-        if (subject == NULL) {
-                WARNING("Bad parameter -> subject == NULL.");
-                return NULL;
+        if (entry->size + count > entry->capacity &&
+                        !grow_tasks(entry, entry->size + count))
+                return false;
+
+        return arena_reserve(&entry->arena, subj_size);
+}
+
+bool dedup_tasks(Tasks *entry, bool on)
+{
+        if (entry == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> entry == NULL.");
+                return false;
         }
 
-        Task *new_task = malloc(sizeof(Task));
+        TaskHash *table = &entry->dedup;
 
-        if (new_task == NULL) {
-                WARNING("Out of memory.");
-                return NULL;
+        if (!on || table->slots != NULL) {
+                if (!on) {
+                        free(table->slots);
+                        table->slots = NULL;
+                        table->capacity = 0;
+                        table->count = 0;
+                }
+
+                return true;
         }
 
-        new_task->index = index;
-        new_task->date = copy_str(date, DATESIZE);
+        long capacity = TASKS_HASH_MIN;
 
-        if (new_task->date == NULL) {
-                WARNING("Bad value -> date == NULL.");
-                return NULL;
+        while (capacity / 2 <= entry->size)
+                capacity *= 2;
+
+        table->slots = calloc(capacity, sizeof(TaskSlot));
+
+        if (table->slots == NULL) {
+                FAIL(ERR_NOMEM, "Out of memory.");
+                return false;
         }
 
-        new_task->status = status;
-        new_task->subject = copy_str(subject, SUBJSIZE);
+        table->capacity = capacity;
+        table->count = 0;
 
-        if (new_task->subject == NULL) {
-                WARNING("Bad value -> subject == NULL.");
-                return NULL;
+        for (long i = 1; i <= entry->size; i++) {
+                const char *subject = task_subject(entry, i);
+
+                hash_insert(table, subject_hash(subject, strlen(subject)), i);
         }
 
-        return new_task;
+        return true;
 }
 
-static char *copy_str(char *src, size_t size)
+static bool has_task(Tasks const *entry, long index)
 {
-        if (src == NULL) {
-                WARNING("Bad parameter -> src == NULL.");
-                return NULL;
-        }
+        return index >= 1 && index <= entry->size;
+}
 
-        char *dest = malloc(size);
+static void set_status(Tasks *entry, long index, bool status)
+{
+        uint64_t bit = UINT64_C(1) << ((index - 1) % TASKS_WORD_BITS);
+        uint64_t *word = &entry->done[(index - 1) / TASKS_WORD_BITS];
 
-        if (dest == NULL) {
-                WARNING("Failed to allocate memory.");
-                return NULL;
-        }
+        if (status)
+                *word |= bit;
+        else
+                *word &= ~bit;
+}
+
+static bool grow_tasks(Tasks *entry, long capacity)
+{
+        if (capacity < TASKS_MIN_CAPACITY)
+                capacity = TASKS_MIN_CAPACITY;
+
+        long old_words = STATUS_WORDS(entry->capacity);
+        long new_words = STATUS_WORDS(capacity);
+
+        Date *dates = realloc(entry->dates, capacity * sizeof(Date));
+
+        if (dates == NULL)
+                goto fail;
+
+        entry->dates = dates;
 
-        strncpy(dest, src, size);
+        char **subjects = realloc(entry->subjects, capacity * sizeof(char *));
 
-        return dest;
+        if (subjects == NULL)
+                goto fail;
+
+        entry->subjects = subjects;
+
+        uint64_t *done = realloc(entry->done, new_words * sizeof(uint64_t));
+
+        if (done == NULL)
+                goto fail;
+
+        memset(done + old_words, 0, (new_words - old_words) *
+                        sizeof(uint64_t));
+        entry->done = done;
+        entry->capacity = capacity;
+        return true;
+
+fail:
+        FAIL(ERR_NOMEM, "Out of memory.");
+        return false;
 }
 
-static Task *find_task(Tasks const *entry, long index)
+static int next_norm(const char **pos, const char *end, bool *started)
 {
-        if (entry == NULL) {
-                WARNING("Bad parameter -> entry == NULL.");
-                return NULL;
+        const char *p = *pos;
+        bool space = false;
+
+        while (p < end && isspace((unsigned char) *p)) {
+                space = true;
+                ++p;
         }
 
-        TasksElmt *el = find_list_elmt(entry, index);
+        *pos = p;
 
-        if (el != NULL) {
-                Task *task = extract_task(el);
+        if (p == end)
+                return -1;
 
-                if (task == NULL) {
-                        WARNING("Failed to extract task.");
-                        return NULL;
-                }
+        /* Run of spaces inside the subject counts as one space. */
+        if (space && *started)
+                return ' ';
+
+        *started = true;
+        *pos = p + 1;
+        return tolower((unsigned char) *p);
+}
 
-                return task;
+static uint64_t subject_hash(const char *subject, size_t len)
+{
+        const char *end = subject + len;
+        bool started = false;
+        uint64_t hash = 14695981039346656037ull;
+        int c = 0;
+
+        while ((c = next_norm(&subject, end, &started)) != -1) {
+                hash ^= (unsigned char) c;
+                hash *= 1099511628211ull;
         }
 
-        return NULL;
+        return hash != 0 ? hash : 1;
 }
 
-static TasksElmt *find_list_elmt(Tasks const *entry, long index)
+static bool same_subject(const char *a, size_t a_len, const char *b,
+                size_t b_len)
 {
-        if (entry == NULL) {
-                WARNING("Bad parameter -> entry == NULL.");
-                return NULL;
-        }
+        const char *a_end = a + a_len;
+        const char *b_end = b + b_len;
+        bool a_started = false;
+        bool b_started = false;
+        int c = 0;
 
-        for (TasksElmt *el = tasks_head(entry); el != NULL; el = next_elmt(el)) {
-                Task *task = extract_task(el);
+        do {
+                c = next_norm(&a, a_end, &a_started);
 
-                if (task == NULL) {
-                        WARNING("Failed to extract task.");
-                        return NULL;
-                }
+                if (c != next_norm(&b, b_end, &b_started))
+                        return false;
+        } while (c != -1);
+
+        return true;
+}
+
+static long hash_find(const Tasks *entry, uint64_t hash, const char *subject,
+                size_t len, long skip)
+{
+        const TaskHash *table = &entry->dedup;
+        size_t mask = table->capacity - 1;
+
+        for (size_t i = hash & mask; table->slots[i].index != 0;
+                        i = (i + 1) & mask) {
+                const TaskSlot *slot = &table->slots[i];
 
-                if (task->index == index)
-                        return el;
+                if (slot->hash != hash || slot->index == skip)
+                        continue;
+
+                const char *other = task_subject(entry, slot->index);
+
+                if (same_subject(subject, len, other, strlen(other)))
+                        return slot->index;
         }
 
-        return NULL;
+        return 0;
 }
 
-static void reindex_tasks(Tasks *entry)
+static bool hash_reserve(TaskHash *table)
 {
-        if (entry == NULL) {
-                WARNING("Bad parameter -> entry == NULL.");
-                return;
+        if ((table->count + 1) * 2 <= table->capacity)
+                return true;
+
+        long capacity = table->capacity * 2;
+        TaskSlot *slots = calloc(capacity, sizeof(TaskSlot));
+
+        if (slots == NULL) {
+                FAIL(ERR_NOMEM, "Out of memory.");
+                return false;
         }
 
-        long i = 1;
-        for (TasksElmt *el = tasks_head(entry); el != NULL; el = next_elmt(el)) {
-                Task *task = extract_task(el);
+        TaskHash old = *table;
 
-                if (task == NULL) {
-                        WARNING("Failed to extract task.");
-                        return;
-                }
+        table->slots = slots;
+        table->capacity = capacity;
+        table->count = 0;
 
-                task->index = i++;
-        }
+        for (long i = 0; i < old.capacity; i++)
+                if (old.slots[i].index != 0)
+                        hash_insert(table, old.slots[i].hash,
+                                        old.slots[i].index);
+
+        free(old.slots);
+        return true;
 }
 
-static Task *extract_task(TasksElmt *el)
+static void hash_insert(TaskHash *table, uint64_t hash, long index)
 {
-        if (el == NULL) {
-                WARNING("Bad parameter -> el == NULL.");
-                return NULL;
-        }
+        size_t mask = table->capacity - 1;
+        size_t i = hash & mask;
 
-        Task *task = (Task *) el->data;
+        while (table->slots[i].index != 0)
+                i = (i + 1) & mask;
 
-        return task;
+        table->slots[i].hash = hash;
+        table->slots[i].index = index;
+        ++table->count;
 }
 
-/* application-specific destroy function (required for dlist interface) */
-void destroy_task(void *data)
+static void hash_remove(TaskHash *table, uint64_t hash, long index)
 {
-        if (data != NULL) {
-                Task *tmp = (Task *) data;
-                free(tmp->date);
-                tmp->date = NULL;
-                free(tmp->subject);
-                tmp->subject = NULL;
-                free(tmp);
-                tmp = NULL;
+        size_t mask = table->capacity - 1;
+        size_t i = hash & mask;
+
+        while (table->slots[i].index != index) {
+                if (table->slots[i].index == 0)
+                        return;
+
+                i = (i + 1) & mask;
         }
+
+        /* Following slots of the probe run are shifted back into the gap. */
+        for (size_t j = (i + 1) & mask; table->slots[j].index != 0;
+                        j = (j + 1) & mask) {
+                size_t home = table->slots[j].hash & mask;
+
+                /* Slot stays if its home is cyclically within (i, j]. */
+                if (i <= j ? (home > i && home <= j) :
+                                (home > i || home <= j))
+                        continue;
+
+                table->slots[i] = table->slots[j];
+                i = j;
+        }
+
+        table->slots[i].index = 0;
+        --table->count;
 }
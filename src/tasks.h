@@ -15,6 +15,7 @@
 #include "date.h"
 #include "error.h"
 #include "io.h"
+#include "journal.h"
 #include "types.h"
 
 /**
@@ -30,39 +31,71 @@
 /**
  * @brief Appends task to the tasklist.
  *
- * If @p subject is not NULL, appends the task to the tail of the tasklist
- * specified by @p entry. If @p subject is NULL, allocates space for
- * a new subject, asks for description and then appends the task. 
+ * Appends the task with the subject specified by @p subject to the tail
+ * of the tasklist specified by @p entry. First letter of the subject is
+ * capitalized. In the dedup mode a duplicate is skipped and the call
+ * still succeeds. Doesn't interact with the user.
  *
  * @param[in,out] entry Pointer to tasklist.
- * @param[in] subject Depending on a situation can be a string for a task
- *            description with the size of SUBJSIZE, which is defined in
- *            types.h, or NULL.
+ * @param[in] subject Read-only string with the task description.
  * @param[in] status Boolean value with the task status (done or undone).
  * @return True on success, or false otherwise.
  */
-bool add_task(Tasks *entry, char *subject, bool status);
+bool add_task(Tasks *entry, const char *subject, bool status);
+
+/**
+ * @brief Appends task with a known date to the tasklist.
+ *
+ * Works like add_task(), but takes the task date from @p date instead of
+ * the current date. Used when tasks are restored from a file.
+ *
+ * @param[in,out] entry Pointer to tasklist.
+ * @param[in] date Task date.
+ * @param[in] subject Read-only string with the task description.
+ * @param[in] status Boolean value with the task status (done or undone).
+ * @return True on success, or false otherwise.
+ */
+bool add_dated_task(Tasks *entry, Date date, const char *subject,
+                bool status);
+
+/**
+ * @brief Appends task with a subject of known length to the tasklist.
+ *
+ * Works like add_dated_task(), but copies exactly @p len bytes of
+ * @p subject, which needn't be terminated, so a subject can be taken
+ * straight from a line of a file.
+ *
+ * @param[in,out] entry Pointer to tasklist.
+ * @param[in] date Task date.
+ * @param[in] subject Read-only task description.
+ * @param[in] len Length of the description.
+ * @param[in] status Boolean value with the task status (done or undone).
+ * @return True on success, or false otherwise.
+ */
+bool add_dated_task_len(Tasks *entry, Date date, const char *subject,
+                size_t len, bool status);
 
 /**
  * @brief Changes description of the existing task.
  *
  * Searches for a task with the index specified by @p index and if it's in
- * the tasklist specified by @p entry, prompts the user for a new description,
- * which substitutes description in the previously found task.
+ * the tasklist specified by @p entry, substitutes its description with
+ * @p subject. In the dedup mode fails if another task has the subject.
+ * Doesn't interact with the user.
  *
  * @param[in,out] entry Pointer to the tasklist.
  * @param[in] index Long int with the index of the task which is to be
  *            substituted.
+ * @param[in] subject Read-only string with the new description.
  * @return True on success, or false otherwise.
  */
-bool change_task(Tasks *entry, long index);
+bool change_task(Tasks *entry, long index, const char *subject);
 
 /**
  * @brief Changes task status to done.
  *
  * Searches for a task with the index specified by @p index and if it's in
- * the list specified by @p entry, calls check_as_done(), which changes it's
- * status to done.
+ * the list specified by @p entry, sets its status bit.
  *
  * @param[in,out] entry Pointer to the tasklist.
  * @param[in] index Long int to the index of a task which status is to be
@@ -75,8 +108,7 @@ bool do_task(Tasks *entry, long index);
  * @brief Changes task status to undone.
  *
  * Searches for a task with the index specified by @p index and if it's in
- * the list specified by @p entry, calls uncheck_done(), which changes it's
- * status to undone.
+ * the list specified by @p entry, clears its status bit.
  *
  * @param[in,out] entry Pointer to the tasklist.
  * @param[in] index Long int with index of a task which status is to be
@@ -86,24 +118,16 @@ bool do_task(Tasks *entry, long index);
 bool undo_task(Tasks *entry, long index);
 
 /**
- * @brief Changes status to done.
- *
- * Takes task specified by @p task and changes its status to done.
- *
- * @param[in,out] task Pointer to the task, which status is to be changed.
- * @return Nothing.
- */
-void check_as_done(Task *task);
-
-/**
- * @brief Changes status to undone.
+ * @brief Changes status of all the tasks.
  *
- * Takes task specified by @p task and changes its status to undone.
+ * Sets status of every task in the list specified by @p entry to
+ * @p status by filling the status bitset a word at a time.
  *
- * @param[in,out] task Pointer to the task, which status is to be changed.
+ * @param[in,out] entry Pointer to the tasklist.
+ * @param[in] status Boolean value with the new status.
  * @return Nothing.
  */
-void uncheck_done(Task *task);
+void set_all_tasks(Tasks *entry, bool status);
 
 /**
  * @brief Deletes task from the tasklist.
@@ -118,39 +142,65 @@ void uncheck_done(Task *task);
 bool delete_task(Tasks *entry, long index);
 
 /**
- * @brief Applies routine to every element of the tasklist.
+ * @brief Initializes task list.
  *
- * Takes tasklist specified by @p entry and applies function specified by
- * @p func to every element.
+ * Must be called for the list specified by @p entry before it's used with
+ * any other operation.
  *
  * @param[in,out] entry Pointer to the tasklist.
- * @param[in] func Pointer to a user-specified function.
  * @return Nothing.
  */
-void traverse_tasks(Tasks *entry, void (*func)(Task *task));
+void init_tasks(Tasks *entry);
 
 /**
- * @brief Constructs task.
+ * @brief Removes all the tasks from the list.
  *
- * Takes index, date, task status, subject and creates a task.
+ * Empties the list specified by @p entry by resetting its arena, so no
+ * task is released one by one. The list stays ready for use.
  *
- * @param[in] index Long int with the index of the task.
- * @param[in] date String with the task date.
- * @param[in] status Boolean value with the task status.
- * @param[in] subject String with the task subject.
- * @return Pointer to created task.
+ * @param[in,out] entry Pointer to the tasklist.
+ * @return Nothing.
  */
-Task *set_task(long index, char *date, bool status, char *subject);
+void reset_tasks(Tasks *entry);
 
 /**
- * @brief Destroys list element's data.
+ * @brief Destroys task list.
  *
- * User-specified destroy function for the list element's data. Required by
- * Doubly-Linked List interface.
+ * Releases all the memory held by the list specified by @p entry. No other
+ * operations are permitted after calling destroy_tasks() unless
+ * init_tasks() is called again.
  *
- * @param[in,out] data Void pointer to the list element's data.
+ * @param[in,out] entry Pointer to the tasklist.
  * @return Nothing.
  */
-void destroy_task(void *data);
+void destroy_tasks(Tasks *entry);
+
+/**
+ * @brief Reserves memory for tasks.
+ *
+ * Makes sure the list specified by @p entry can take @p count more tasks
+ * with subjects of @p subj_size bytes in total, terminators included,
+ * without another allocation.
+ *
+ * @param[in,out] entry Pointer to the tasklist.
+ * @param[in] count Number of tasks to reserve memory for.
+ * @param[in] subj_size Total size of their subjects.
+ * @return True on success, or false otherwise.
+ */
+bool reserve_tasks(Tasks *entry, long count, size_t subj_size);
+
+/**
+ * @brief Turns the dedup mode on or off.
+ *
+ * In the dedup mode a task whose subject equals the subject of a task in
+ * the list, ignoring case and extra spaces, is not added, and a task
+ * can't be changed into a duplicate of another one. Turning the mode on
+ * indexes the tasks already in the list, which may hold duplicates.
+ *
+ * @param[in,out] entry Pointer to the tasklist.
+ * @param[in] on True to turn the mode on, false to turn it off.
+ * @return True on success, or false otherwise.
+ */
+bool dedup_tasks(Tasks *entry, bool on);
 
 #endif
@@ -10,8 +10,11 @@
 #define TYPES_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
-#include "dlist.h"
+#include "arena.h"
+#include "lists.h"
 
 /** String length for a line, which read from or written to file. */
 #define LINESIZE    128
@@ -22,9 +25,6 @@
 /** String length for a task status. */
 #define STATSIZE    2
 
-/** String length for a task subject. */
-#define SUBJSIZE    76
-
 /**
  * Offset which defines that the date sits between 0 and DATEOFFSET
  * characters in the read line.
@@ -41,10 +41,16 @@
 #define SUBJOFFSET  13
 
 /** Address and name of the file which contains the last entry. */
-#define LAST_ENTRY  "./txt/last_entry.txt"
+#define LAST_ENTRY  (list_paths()->last_entry)
+
+/** Single-file tasks history of older versions, moved into segments. */
+#define HISTORY     (list_paths()->history)
+
+/** Date index of the single-file history of older versions. */
+#define HISTORY_IDX (list_paths()->history_idx)
 
-/** Address and name of the file which contains tasks history. */
-#define HISTORY     "./txt/history.txt"
+/** Address and name of the file which contains the last entry journal. */
+#define JOURNAL     (list_paths()->journal)
 
 /**
  * @brief Custom macro for strings comparison.
@@ -54,51 +60,122 @@
  */
 #define STRCMP(a, R, b) (strcmp(a, b) R 0)
 
-/** Type definition for task. */
-typedef struct Task_tag {
-        long index; ///< Task index of type long.
-        char *date; ///< Pointer to task date string.
-        char *subject; ///< Pointer to subject string.
-        bool status; ///< Boolean value for a task status.
-} Task;
+/**
+ * @brief Type definition for a date.
+ *
+ * Day, month and year are packed into one integer as yyyy:mm:ddddd bits,
+ * so dates can be ordered with plain integer comparison. Zero is never
+ * a valid date.
+ */
+typedef uint32_t Date;
 
-/** Type definition for element in task list. */
-typedef DListElmt TasksElmt;
+/** Packs day, month and year into a Date. */
+#define DATE_PACK(d, m, y) (((Date) (y) << 9) | ((Date) (m) << 5) | (Date) (d))
 
-/** Type definition for a task list. */
-typedef DList Tasks;
+/** Evaluates to the day of a Date. */
+#define DATE_DAY(date)     ((date) & 0x1f)
 
-/** @see dlist_size */
-#define tasks_size      dlist_size
+/** Evaluates to the month of a Date. */
+#define DATE_MONTH(date)   (((date) >> 5) & 0x0f)
 
-/** @see dlist_head */
-#define tasks_head      dlist_head
+/** Evaluates to the year of a Date. */
+#define DATE_YEAR(date)    ((date) >> 9)
 
-/** @see dlist_tail */
-#define tasks_tail      dlist_tail
+/** Evaluates to the month key of a Date: the date with the day cleared. */
+#define DATE_MONTH_KEY(date) ((date) & ~(Date) 0x1f)
 
-/** @see dlist_next */
-#define next_elmt       dlist_next
+/** Type definition for a read-only view of a task line. */
+typedef struct TaskView_tag {
+        Date date; ///< Task date.
+        const char *subject; ///< Pointer to the subject, not terminated.
+        size_t subj_len; ///< Length of the subject.
+        bool status; ///< Boolean value for a task status.
+} TaskView;
 
-/** @see dlist_prev */
-#define prev_elmt       dlist_prev
+/** Number of task status bits in one word of the bitset. */
+#define TASKS_WORD_BITS 64
 
-/** @see dlist_data */
-#define elmt_data       dlist_data
+/** Number of slots of a new subject hash table, a power of two. */
+#define TASKS_HASH_MIN  64
 
-/** @see dlist_init */
-#define init_tasks      dlist_init
+/**
+ * @brief Type definition for a slot of the subject hash table.
+ */
+typedef struct TaskSlot_tag {
+        uint64_t hash; ///< Hash of the normalized subject.
+        long     index; ///< Task index, or 0 for an empty slot.
+} TaskSlot;
 
-/** @see dlist_destroy */
-#define destroy_tasks   dlist_destroy
+/**
+ * @brief Type definition for the subject hash table.
+ *
+ * Open addressing with linear probing, kept at most half full. Slots are
+ * freed with backward shifting, so there are no tombstones.
+ */
+typedef struct TaskHash_tag {
+        TaskSlot *slots; ///< Array of slots, or NULL if dedup is off.
+        long     capacity; ///< Number of slots, a power of two.
+        long     count; ///< Number of used slots.
+} TaskHash;
 
-/** @see dlist_ins_nest */
-#define ins_task_after  dlist_ins_next
+/**
+ * @brief Type definition for a task list.
+ *
+ * Tasks are kept as a structure of arrays in the order they were added,
+ * so the position of a task is its index. Statuses are packed into
+ * a bitset, so bulk status operations work a word at a time; bits past
+ * the last task are always clear. Subjects live in the arena, so the
+ * whole list is released at once. In the dedup mode, a hash table of
+ * normalized subjects finds duplicates without walking the list.
+ */
+typedef struct Tasks_tag {
+        Date     *dates; ///< Array of task dates.
+        char     **subjects; ///< Array of pointers to subjects in the arena.
+        uint64_t *done; ///< Status bitset, bit set for a done task.
+        long     size; ///< Number of tasks in the list.
+        long     capacity; ///< Number of tasks the arrays can hold.
+        Arena    arena; ///< Storage for task subjects.
+        TaskHash dedup; ///< Subject hash table of the dedup mode.
+        struct Journal_tag *journal; ///< Operation journal, or NULL.
+} Tasks;
+
+/** Size of the first arena block of a task list. */
+#define TASKS_ARENA_BLOCK  4096
+
+/** Number of tasks the arrays hold after the first growth. */
+#define TASKS_MIN_CAPACITY 64
+
+/**
+ * @brief Gets number of tasks in the list.
+ * @param[in] entry Pointer to a read-only task list.
+ * @return Long int with the number of tasks.
+ */
+#define tasks_size(entry)  ((entry)->size)
 
-/** @see dlist_ins_prev */
-#define ins_task_before dlist_ins_prev
+/**
+ * @brief Gets task date by index.
+ *
+ * Indexes start from 1, as they are shown to the user. Index must be
+ * checked by the caller.
+ *
+ * @param[in] entry Pointer to a task list.
+ * @param[in] index Long int with the task index.
+ * @return Date of the task.
+ */
+#define task_date(entry, index) ((entry)->dates[(index) - 1])
 
-/** @see dlist_remove */
-#define remove_elmt     dlist_remove
+/**
+ * @brief Gets task subject by index.
+ * @see task_date
+ */
+#define task_subject(entry, index) ((entry)->subjects[(index) - 1])
+
+/**
+ * @brief Gets task status by index.
+ * @see task_date
+ */
+#define task_status(entry, index) \
+        ((bool) (((entry)->done[((index) - 1) / TASKS_WORD_BITS] >> \
+                  (((index) - 1) % TASKS_WORD_BITS)) & 1))
 
 #endif
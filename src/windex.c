@@ -0,0 +1,441 @@
+/**
+ * @file windex.c
+ * @brief Function definitions for the history word index.
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "archive.h"
+#include "date.h"
+#include "error.h"
+#include "lines.h"
+#include "mapfile.h"
+#include "store.h"
+#include "windex.h"
+
+/** Stamp of the index which is being rebuilt. */
+#define WINDEX_REBUILDING UINT64_MAX
+
+/** Offset of the first posting record in the index file. */
+#define WINDEX_RECORDS (sizeof(WIndexHdr) + WINDEX_BUCKETS * sizeof(uint64_t))
+
+/**
+ * @brief Opens index file and loads chain heads.
+ * @param[in,out] index Pointer to the index, which is to be set.
+ * @param[in] fresh True to start an empty index, false to open existing.
+ * @return True on success, or false otherwise.
+ */
+static bool start_index(WIndex *index, bool fresh);
+
+/**
+ * @brief Closes index file and frees its buffers.
+ * @param[in,out] index Pointer to the index.
+ * @return Nothing.
+ */
+static void release_index(WIndex *index);
+
+/**
+ * @brief Makes sure the index describes the history.
+ * @param[in] man Pointer to the read-only manifest.
+ * @return True on success, or false otherwise.
+ */
+static bool sync_index(const Manifest *man);
+
+/**
+ * @brief Rebuilds the index from all history segments.
+ * @param[in] man Pointer to the read-only manifest.
+ * @return True on success, or false otherwise.
+ */
+static bool rebuild_index(const Manifest *man);
+
+/**
+ * @brief Indexes all lines of a history segment.
+ * @param[in,out] index Pointer to the open index.
+ * @param[in] data Lines, may be NULL if @p size is 0.
+ * @param[in] size Size of the lines in bytes.
+ * @return True on success, or false otherwise.
+ */
+static bool add_lines(WIndex *index, const char *data, size_t size);
+
+/**
+ * @brief Remembers word as indexed for the current date.
+ * @param[in,out] index Pointer to the open index.
+ * @param[in] word Hash of the word.
+ * @return True if the word is new for the date, or false otherwise.
+ */
+static bool see_word(WIndex *index, uint64_t word);
+
+/**
+ * @brief Reads and checks index header.
+ * @param[in] fd Descriptor of the index file.
+ * @param[in,out] hdr Header, where read values are to be stored.
+ * @return True if header is valid, or false otherwise.
+ */
+static bool read_hdr(int fd, WIndexHdr *hdr);
+
+bool next_word(const char **pos, const char *end, uint64_t *word)
+{
+        const unsigned char *p = (const unsigned char *) *pos;
+        const unsigned char *e = (const unsigned char *) end;
+
+        while (p < e) {
+                while (p < e && !isalnum(*p) && *p < 0x80)
+                        ++p;
+
+                const unsigned char *start = p;
+                uint64_t hash = UINT64_C(14695981039346656037);
+
+                while (p < e && (isalnum(*p) || *p >= 0x80)) {
+                        hash ^= tolower(*p++);
+                        hash *= UINT64_C(1099511628211);
+                }
+
+                if (p - start >= WORD_MIN_LEN) {
+                        *pos = (const char *) p;
+                        *word = hash;
+                        return true;
+                }
+        }
+
+        *pos = end;
+        return false;
+}
+
+bool windex_open(WIndex *index, const Manifest *man)
+{
+        if (index == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> index == NULL.");
+                return false;
+        }
+
+        if (man == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> man == NULL.");
+                return false;
+        }
+
+        index->fd = -1;
+        return sync_index(man) && start_index(index, false);
+}
+
+bool windex_add(WIndex *index, const char *line, size_t len)
+{
+        if (index == NULL || index->fd < 0) {
+                FAIL(ERR_PARAM, "Bad parameter -> index isn't open.");
+                return false;
+        }
+
+        Date date = 0;
+
+        if (len <= SUBJOFFSET || !date_is_valid(line, &date))
+                return true;
+
+        if (date != index->seen_date) {
+                memset(index->seen, 0, sizeof(index->seen));
+                index->nseen = 0;
+                index->seen_date = date;
+        }
+
+        const char *pos = line + SUBJOFFSET;
+        const char *end = line + len;
+        uint64_t word = 0;
+
+        while (next_word(&pos, end, &word)) {
+                if (!see_word(index, word))
+                        continue;
+
+                if (index->npending == index->cap) {
+                        size_t cap = index->cap ? index->cap * 2 : 256;
+                        WIndexRec *tmp = realloc(index->pending,
+                                        cap * sizeof(WIndexRec));
+
+                        if (tmp == NULL) {
+                                FAIL(ERR_NOMEM, "Out of memory.");
+                                return false;
+                        }
+
+                        index->pending = tmp;
+                        index->cap = cap;
+                }
+
+                uint64_t *head = &index->heads[word % WINDEX_BUCKETS];
+                WIndexRec rec = { *head, word, date, 0 };
+
+                index->pending[index->npending++] = rec;
+                *head = index->size;
+                index->size += sizeof(WIndexRec);
+        }
+
+        return true;
+}
+
+bool windex_close(WIndex *index, uint64_t stamp)
+{
+        if (index == NULL || index->fd < 0)
+                return false;
+
+        size_t rec_size = index->npending * sizeof(WIndexRec);
+        WIndexHdr hdr = { { 0 }, WINDEX_VERSION, WINDEX_BUCKETS, 0, stamp };
+
+        memcpy(hdr.magic, WINDEX_MAGIC, sizeof(hdr.magic));
+
+        /* Records go first, heads point to them, header seals it all. */
+        bool ok = pwrite(index->fd, index->pending, rec_size,
+                        index->size - rec_size) == (ssize_t) rec_size &&
+                pwrite(index->fd, index->heads, WINDEX_BUCKETS *
+                                sizeof(uint64_t), sizeof(WIndexHdr)) ==
+                (ssize_t) (WINDEX_BUCKETS * sizeof(uint64_t)) &&
+                pwrite(index->fd, &hdr, sizeof(WIndexHdr), 0) ==
+                (ssize_t) sizeof(WIndexHdr);
+
+        if (!ok)
+                FAIL(ERR_IO, "Failed to write word index.");
+
+        release_index(index);
+        return ok;
+}
+
+long windex_find(const Manifest *man, uint64_t word, Date **dates)
+{
+        if (man == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> man == NULL.");
+                return -1;
+        }
+
+        if (dates == NULL) {
+                FAIL(ERR_PARAM, "Bad parameter -> dates == NULL.");
+                return -1;
+        }
+
+        *dates = NULL;
+
+        if (!sync_index(man))
+                return -1;
+
+        int fd = open(WINDEX_FILE, O_RDONLY);
+        WIndexHdr hdr;
+        uint64_t next = 0;
+
+        if (fd < 0 || !read_hdr(fd, &hdr) ||
+                        pread(fd, &next, sizeof(next), sizeof(WIndexHdr) +
+                                (word % WINDEX_BUCKETS) * sizeof(uint64_t)) !=
+                        (ssize_t) sizeof(next)) {
+                WARNING("Failed to read word index.");
+                if (fd >= 0)
+                        close(fd);
+                return -1;
+        }
+
+        long count = 0;
+        long cap = 0;
+
+        /* Chain always goes back in the file, so it can't loop. */
+        while (next >= WINDEX_RECORDS) {
+                WIndexRec rec;
+
+                if (pread(fd, &rec, sizeof(rec), next) != sizeof(rec) ||
+                                (rec.next != 0 && rec.next >= next))
+                        break;
+
+                next = rec.next;
+
+                if (rec.word != word)
+                        continue;
+
+                if (count == cap) {
+                        cap = cap ? cap * 2 : 64;
+                        Date *tmp = realloc(*dates, cap * sizeof(Date));
+
+                        if (tmp == NULL) {
+                                FAIL(ERR_NOMEM, "Out of memory.");
+                                free(*dates);
+                                *dates = NULL;
+                                close(fd);
+                                return -1;
+                        }
+
+                        *dates = tmp;
+                }
+
+                (*dates)[count++] = rec.date;
+        }
+
+        close(fd);
+        return count;
+}
+
+static bool start_index(WIndex *index, bool fresh)
+{
+        index->fd = open(WINDEX_FILE, O_RDWR | O_CREAT |
+                        (fresh ? O_TRUNC : 0), 0644);
+        index->heads = calloc(WINDEX_BUCKETS, sizeof(uint64_t));
+        index->size = WINDEX_RECORDS;
+        index->pending = NULL;
+        index->npending = 0;
+        index->cap = 0;
+        index->seen_date = 0;
+        index->nseen = 0;
+
+        if (index->fd < 0 || index->heads == NULL) {
+                WARNING("Failed to open word index.");
+                release_index(index);
+                return false;
+        }
+
+        WIndexHdr hdr;
+
+        if (fresh) {
+                /* Index is unusable until windex_close() stamps it. */
+                WIndexHdr blank = { { 0 }, WINDEX_VERSION, WINDEX_BUCKETS,
+                        0, WINDEX_REBUILDING };
+
+                memcpy(blank.magic, WINDEX_MAGIC, sizeof(blank.magic));
+
+                if (pwrite(index->fd, &blank, sizeof(blank), 0) ==
+                                (ssize_t) sizeof(blank))
+                        return true;
+
+                FAIL(ERR_IO, "Failed to write word index.");
+                release_index(index);
+                return false;
+        }
+
+        off_t size = lseek(index->fd, 0, SEEK_END);
+
+        if (!read_hdr(index->fd, &hdr) || size < (off_t) WINDEX_RECORDS ||
+                        pread(index->fd, index->heads, WINDEX_BUCKETS *
+                                sizeof(uint64_t), sizeof(WIndexHdr)) !=
+                        (ssize_t) (WINDEX_BUCKETS * sizeof(uint64_t))) {
+                WARNING("Failed to read word index.");
+                release_index(index);
+                return false;
+        }
+
+        index->size = size;
+        return true;
+}
+
+static void release_index(WIndex *index)
+{
+        if (index->fd >= 0)
+                close(index->fd);
+
+        index->fd = -1;
+        free(index->heads);
+        index->heads = NULL;
+        free(index->pending);
+        index->pending = NULL;
+        index->npending = 0;
+        index->cap = 0;
+}
+
+static bool sync_index(const Manifest *man)
+{
+        int fd = open(WINDEX_FILE, O_RDONLY);
+        WIndexHdr hdr;
+
+        if (fd >= 0) {
+                bool fresh = read_hdr(fd, &hdr) && hdr.stamp == man->stamp;
+
+                close(fd);
+
+                if (fresh)
+                        return true;
+        }
+
+        return rebuild_index(man);
+}
+
+static bool rebuild_index(const Manifest *man)
+{
+        WIndex index;
+
+        if (!start_index(&index, true))
+                return false;
+
+        bool ok = true;
+
+        for (long i = 0; ok && i < man->size; i++) {
+                char path[SEGMENT_PATHSIZE] = { 0 };
+                char *archived = NULL;
+                size_t archived_len = 0;
+                MapFile segment = { NULL, 0 };
+
+                ok = archive_read(man->segs[i].month, 0, &archived,
+                                &archived_len) &&
+                        add_lines(&index, archived, archived_len);
+                free(archived);
+                archived = NULL;
+
+                segment_path(man->segs[i].month, SEGMENT_TEXT, path);
+
+                if (ok && !map_file(path, &segment) && errno != ENOENT)
+                        ok = false;
+
+                if (ok)
+                        ok = add_lines(&index, segment.data, segment.size);
+
+                unmap_file(&segment);
+        }
+
+        if (!ok) {
+                WARNING("Failed to rebuild word index.");
+                windex_close(&index, WINDEX_REBUILDING);
+                return false;
+        }
+
+        return windex_close(&index, man->stamp);
+}
+
+static bool add_lines(WIndex *index, const char *data, size_t size)
+{
+        const char *pos = data;
+        const char *end = data + size;
+        LineBatch batch;
+
+        while (lines_split(&pos, end, &batch) > 0)
+                for (size_t i = 0; i < batch.count; i++)
+                        if (!windex_add(index, batch.starts[i],
+                                                batch.lens[i]))
+                                return false;
+
+        return true;
+}
+
+static bool see_word(WIndex *index, uint64_t word)
+{
+        /* Table is kept at most half full, so probing always ends. */
+        if (index->nseen >= WINDEX_SEEN / 2) {
+                memset(index->seen, 0, sizeof(index->seen));
+                index->nseen = 0;
+        }
+
+        size_t slot = word % WINDEX_SEEN;
+
+        while (index->seen[slot] != 0) {
+                if (index->seen[slot] == word)
+                        return false;
+
+                slot = (slot + 1) % WINDEX_SEEN;
+        }
+
+        index->seen[slot] = word;
+        ++index->nseen;
+        return true;
+}
+
+static bool read_hdr(int fd, WIndexHdr *hdr)
+{
+        if (pread(fd, hdr, sizeof(WIndexHdr), 0) != sizeof(WIndexHdr))
+                return false;
+
+        return memcmp(hdr->magic, WINDEX_MAGIC, sizeof(hdr->magic)) == 0 &&
+                hdr->version == WINDEX_VERSION &&
+                hdr->buckets == WINDEX_BUCKETS;
+}
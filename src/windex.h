@@ -0,0 +1,150 @@
+/**
+ * @file windex.h
+ * @brief Interface for the history word index.
+ *
+ * The word index maps every word of task subjects to the dates of the
+ * entries it occurs in. It's a single file in the history directory:
+ * a header, a table of WINDEX_BUCKETS chain heads, and posting records.
+ * Words are hashed into buckets and every bucket is a chain of records,
+ * newest first, so the latest dates of a word come out first. New
+ * records are only appended, so saving an entry costs a few records
+ * and one rewrite of the chain heads.
+ *
+ * The header keeps the stamp of the manifest the index was made for.
+ * History bumps the stamp before it changes, so index which missed some
+ * change is found stale and rebuilt.
+ *
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#ifndef WINDEX_H
+#define WINDEX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "history.h"
+#include "types.h"
+
+/** Address and name of the word index file. */
+#define WINDEX_FILE    (list_paths()->words)
+
+/** Magic bytes at the start of the word index file. */
+#define WINDEX_MAGIC   "DWRD"
+
+/** Version of the word index file layout. */
+#define WINDEX_VERSION 1
+
+/** Number of chains in the word index. */
+#define WINDEX_BUCKETS 4096
+
+/** Number of slots in the table of words already seen for a date. */
+#define WINDEX_SEEN    1024
+
+/** Shortest word which is indexed. */
+#define WORD_MIN_LEN   2
+
+/**
+ * @brief Type definition for the word index file header.
+ */
+typedef struct WIndexHdr_tag {
+        char     magic[4]; ///< WINDEX_MAGIC.
+        uint32_t version; ///< WINDEX_VERSION.
+        uint32_t buckets; ///< WINDEX_BUCKETS.
+        uint32_t reserved; ///< Always 0.
+        uint64_t stamp; ///< Stamp of the manifest the index describes.
+} WIndexHdr;
+
+/**
+ * @brief Type definition for the posting record.
+ */
+typedef struct WIndexRec_tag {
+        uint64_t next; ///< Offset of the next record in the chain, or 0.
+        uint64_t word; ///< Hash of the word.
+        Date     date; ///< Date of the entry the word occurs in.
+        uint32_t reserved; ///< Always 0.
+} WIndexRec;
+
+/**
+ * @brief Type definition for the word index open for appending.
+ */
+typedef struct WIndex_tag {
+        int       fd; ///< Descriptor of the index file, or -1.
+        uint64_t  *heads; ///< Chain heads.
+        uint64_t  size; ///< Size of the index file with pending records.
+        WIndexRec *pending; ///< Records not yet written.
+        size_t    npending; ///< Number of pending records.
+        size_t    cap; ///< Number of records @p pending can hold.
+        Date      seen_date; ///< Date the seen words belong to.
+        uint64_t  seen[WINDEX_SEEN]; ///< Words already indexed for the date.
+        long      nseen; ///< Number of seen words.
+} WIndex;
+
+/**
+ * @brief Gets next word.
+ *
+ * Finds the next word at @p pos, which is a run of letters, digits or
+ * non-ASCII bytes, and stores the hash of its lowercased form into
+ * @p word. @p pos is moved past the word. Words shorter than
+ * WORD_MIN_LEN are skipped.
+ *
+ * @param[in,out] pos Pointer to the current position.
+ * @param[in] end Pointer to the end of the text.
+ * @param[in,out] word Pointer, where the word hash is to be stored.
+ * @return True if a word was found, or false at the end of the text.
+ */
+bool next_word(const char **pos, const char *end, uint64_t *word);
+
+/**
+ * @brief Opens word index for appending.
+ *
+ * Opens the index and rebuilds it first if it doesn't describe the
+ * history specified by @p man. Index must be closed with windex_close().
+ *
+ * @param[in,out] index Pointer to the index, which is to be set.
+ * @param[in] man Pointer to the read-only manifest.
+ * @return True on success, or false otherwise.
+ */
+bool windex_open(WIndex *index, const Manifest *man);
+
+/**
+ * @brief Indexes history line.
+ *
+ * Adds the words of the subject of the history line specified by @p line
+ * and @p len to the index.
+ *
+ * @param[in,out] index Pointer to the open index.
+ * @param[in] line Read-only line, not terminated.
+ * @param[in] len Length of the line.
+ * @return True on success, or false otherwise.
+ */
+bool windex_add(WIndex *index, const char *line, size_t len);
+
+/**
+ * @brief Closes word index.
+ *
+ * Writes pending records, chain heads and the header with @p stamp.
+ *
+ * @param[in,out] index Pointer to the open index.
+ * @param[in] stamp Stamp of the manifest the index now describes.
+ * @return True on success, or false otherwise.
+ */
+bool windex_close(WIndex *index, uint64_t stamp);
+
+/**
+ * @brief Finds dates of the word.
+ *
+ * Walks the chain of @p word and stores dates of the entries it occurs
+ * in, newest first, into a newly allocated array. Dates may repeat. It's
+ * responsibility of the caller to free the array.
+ *
+ * @param[in] man Pointer to the read-only manifest.
+ * @param[in] word Hash of the word, see next_word().
+ * @param[in,out] dates Pointer, where the array is to be stored.
+ * @return Number of found dates, or -1 on failure.
+ */
+long windex_find(const Manifest *man, uint64_t word, Date **dates);
+
+#endif
@@ -0,0 +1,477 @@
+/**
+ * @file gen.c
+ * @brief Generator of synthetic history and entry files.
+ *
+ * Writes task lines in the layout of types.h: the date at 0, the status at
+ * STATOFFSET and the subject from SUBJOFFSET. Output is made of:
+ *
+ *      - @p days days starting from the first date, one per day
+ *      - tasks per day, a number or a uniform MIN:MAX range
+ *      - subject lengths, uniform:MIN:MAX or normal:MEAN:SD, at most
+ *        ENTRY_SUBJMAX
+ *      - done ratio, the share of done tasks
+ *      - bad ratio, the share of deliberately malformed lines
+ *
+ * The same seed always gives the same output. Subjects are cut from
+ * a pool of words made at start, so a line costs a couple of memcpy()
+ * calls and gigabytes are written in seconds.
+ *
+ * @author Vitaliy Pisnya
+ * @date October, 2026
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "date.h"
+#include "error.h"
+#include "store.h"
+#include "types.h"
+
+/** Size of the output buffer. */
+#define GEN_BUFSIZE  (1 << 20)
+
+/** Size of the pool subjects are cut from, several of the longest ones. */
+#define GEN_POOLSIZE (4 * (ENTRY_SUBJMAX + 1))
+
+/** Default first date of a history. */
+#define GEN_FIRST    "01.01.2016"
+
+/**
+ * @brief Type definition for subject length distributions.
+ */
+typedef enum GenDist_tag {
+        GEN_UNIFORM, ///< Uniform from a to b.
+        GEN_NORMAL ///< Normal with mean a and deviation b.
+} GenDist;
+
+/**
+ * @brief Type definition for the generator options.
+ */
+typedef struct GenOpts_tag {
+        long     days; ///< Number of days.
+        long     tasks_min; ///< Minimum number of tasks per day.
+        long     tasks_max; ///< Maximum number of tasks per day.
+        GenDist  dist; ///< Subject length distribution.
+        long     len_a; ///< First parameter of the distribution.
+        long     len_b; ///< Second parameter of the distribution.
+        double   done_ratio; ///< Share of done tasks.
+        double   bad_ratio; ///< Share of malformed lines.
+        uint64_t seed; ///< Seed of the generator.
+        Date     first; ///< First date.
+        const char *path; ///< Output file, or NULL for stdout.
+} GenOpts;
+
+/**
+ * @brief Parses command line into @p opts.
+ * @return True on success, or false on a bad option.
+ */
+static bool parse_opts(int argc, char *argv[], GenOpts *opts);
+
+/**
+ * @brief Parses "N" or "MIN:MAX" into a range.
+ */
+static bool parse_range(const char *str, long *min, long *max);
+
+/**
+ * @brief Parses "uniform:MIN:MAX" or "normal:MEAN:SD".
+ */
+static bool parse_dist(const char *str, GenOpts *opts);
+
+/**
+ * @brief Gets next pseudo-random number.
+ */
+static uint64_t next_rand(void);
+
+/**
+ * @brief Gets pseudo-random number from 0 to 1 exclusive.
+ */
+static double next_unit(void);
+
+/**
+ * @brief Gets pseudo-random number from @p min to @p max inclusive.
+ */
+static long next_range(long min, long max);
+
+/**
+ * @brief Draws subject length from the distribution.
+ */
+static long next_len(const GenOpts *opts);
+
+/**
+ * @brief Fills the pool with words.
+ */
+static void fill_pool(void);
+
+/**
+ * @brief Appends line to the output buffer.
+ * @return True on success, or false if the output can't be written.
+ */
+static bool put_line(FILE *fp, const char *date, bool status, long len);
+
+/**
+ * @brief Appends malformed line to the output buffer.
+ */
+static bool put_bad_line(FILE *fp, const char *date);
+
+/**
+ * @brief Appends bytes to the output buffer.
+ */
+static bool put(FILE *fp, const char *data, size_t len);
+
+/**
+ * @brief Writes the output buffer.
+ */
+static bool flush_out(FILE *fp);
+
+/**
+ * @brief Gets the day after @p date.
+ */
+static Date next_day(Date date);
+
+/** State of the pseudo-random generator. */
+static uint64_t rand_state;
+
+/** Words subjects are cut from. */
+static char pool[GEN_POOLSIZE];
+
+/** Output buffer. */
+static char out[GEN_BUFSIZE];
+
+/** Number of bytes in the output buffer. */
+static size_t out_len = 0;
+
+/** Words the pool is made of. */
+static const char *words[] = {
+        "buy", "milk", "call", "mom", "fix", "bike", "read", "book", "pay",
+        "rent", "write", "report", "clean", "kitchen", "walk", "dog", "send",
+        "invoice", "plan", "trip", "review", "patch", "water", "plants",
+        "meet", "team", "tickets", "flight", "renew", "passport", "cook",
+        "dinner", "backup", "laptop", "update", "resume", "gym", "visit",
+        "dentist", "order", "groceries", "learn", "spanish", "answer",
+        "emails", "prepare", "slides", "return", "library", "books"
+};
+
+int main(int argc, char *argv[])
+{
+        GenOpts opts = {
+                365, 5, 5, GEN_UNIFORM, 8, 40, 0.5, 0.0, 1, 0, NULL
+        };
+
+        if (!parse_opts(argc, argv, &opts)) {
+                fprintf(stderr, "usage: %s [-d days] [-t tasks|min:max] "
+                                "[-l uniform:min:max|normal:mean:sd]\n"
+                                "       [-r done_ratio] [-b bad_ratio] "
+                                "[-s seed] [-f dd.mm.yyyy] [-e] [-o file]\n",
+                                argv[0]);
+                return EXIT_FAILURE;
+        }
+
+        FILE *fp = opts.path ? fopen(opts.path, "w") : stdout;
+
+        if (fp == NULL) {
+                fprintf(stderr, "gen: can't open %s: %s\n", opts.path,
+                                CLEAN_ERRNO());
+                return EXIT_FAILURE;
+        }
+
+        rand_state = opts.seed ? opts.seed : 1;
+        fill_pool();
+
+        Date date = opts.first;
+        bool ok = true;
+
+        for (long day = 0; ok && day < opts.days; day++) {
+                char str[16];
+                long tasks = next_range(opts.tasks_min, opts.tasks_max);
+
+                snprintf(str, sizeof(str), "%02u.%02u.%04u",
+                                (unsigned) DATE_DAY(date),
+                                (unsigned) DATE_MONTH(date),
+                                (unsigned) DATE_YEAR(date));
+
+                for (long i = 0; ok && i < tasks; i++) {
+                        if (opts.bad_ratio > 0 &&
+                                        next_unit() < opts.bad_ratio)
+                                ok = put_bad_line(fp, str);
+                        else
+                                ok = put_line(fp, str,
+                                                next_unit() < opts.done_ratio,
+                                                next_len(&opts));
+                }
+
+                date = next_day(date);
+        }
+
+        ok = ok && flush_out(fp);
+
+        if (opts.path && fclose(fp) != 0)
+                ok = false;
+
+        if (!ok)
+                fprintf(stderr, "gen: write failed: %s\n", CLEAN_ERRNO());
+
+        return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static bool parse_opts(int argc, char *argv[], GenOpts *opts)
+{
+        const char *first = NULL;
+        bool entry = false;
+        int opt = 0;
+
+        while ((opt = getopt(argc, argv, "d:t:l:r:b:s:f:eo:")) != -1) {
+                switch (opt) {
+                        case 'd':
+                                opts->days = strtol(optarg, NULL, 10);
+                                break;
+
+                        case 't':
+                                if (!parse_range(optarg, &opts->tasks_min,
+                                                        &opts->tasks_max))
+                                        return false;
+                                break;
+
+                        case 'l':
+                                if (!parse_dist(optarg, opts))
+                                        return false;
+                                break;
+
+                        case 'r':
+                                opts->done_ratio = strtod(optarg, NULL);
+                                break;
+
+                        case 'b':
+                                opts->bad_ratio = strtod(optarg, NULL);
+                                break;
+
+                        case 's':
+                                opts->seed = strtoull(optarg, NULL, 10);
+                                break;
+
+                        case 'f':
+                                first = optarg;
+                                break;
+
+                        case 'e':
+                                entry = true;
+                                break;
+
+                        case 'o':
+                                opts->path = optarg;
+                                break;
+
+                        default:
+                                return false;
+                }
+        }
+
+        if (optind != argc || opts->days < 0)
+                return false;
+
+        /* Entry is one day, today unless the date is given. */
+        if (entry) {
+                opts->days = 1;
+
+                if (first == NULL)
+                        return get_curr_date(&opts->first);
+        }
+
+        if (first == NULL)
+                first = GEN_FIRST;
+
+        return strlen(first) == DATEOFFSET &&
+                date_is_valid(first, &opts->first);
+}
+
+static bool parse_range(const char *str, long *min, long *max)
+{
+        char *end = NULL;
+
+        *min = strtol(str, &end, 10);
+        *max = *end == ':' ? strtol(end + 1, &end, 10) : *min;
+
+        return *end == '\0' && *min >= 0 && *max >= *min;
+}
+
+static bool parse_dist(const char *str, GenOpts *opts)
+{
+        const char *colon = strchr(str, ':');
+
+        if (colon == NULL)
+                return false;
+
+        if (strncmp(str, "uniform", colon - str) == 0)
+                opts->dist = GEN_UNIFORM;
+        else if (strncmp(str, "normal", colon - str) == 0)
+                opts->dist = GEN_NORMAL;
+        else
+                return false;
+
+        char *end = NULL;
+
+        opts->len_a = strtol(colon + 1, &end, 10);
+
+        if (*end != ':')
+                return false;
+
+        opts->len_b = strtol(end + 1, &end, 10);
+
+        return *end == '\0' && opts->len_a >= 0 && opts->len_b >= 0 &&
+                (opts->dist == GEN_NORMAL || opts->len_b >= opts->len_a);
+}
+
+static uint64_t next_rand(void)
+{
+        rand_state ^= rand_state >> 12;
+        rand_state ^= rand_state << 25;
+        rand_state ^= rand_state >> 27;
+        return rand_state * 0x2545f4914f6cdd1dull;
+}
+
+static double next_unit(void)
+{
+        return (next_rand() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static long next_range(long min, long max)
+{
+        return min + (long) (next_rand() % (uint64_t) (max - min + 1));
+}
+
+static long next_len(const GenOpts *opts)
+{
+        long len = opts->len_a;
+
+        if (opts->dist == GEN_UNIFORM) {
+                len = next_range(opts->len_a, opts->len_b);
+        } else {
+                /* Sum of twelve uniform numbers is close to normal. */
+                double sum = -6.0;
+
+                for (int i = 0; i < 12; i++)
+                        sum += next_unit();
+
+                len = opts->len_a + (long) (sum * opts->len_b);
+        }
+
+        if (len < 1)
+                return 1;
+
+        return len < ENTRY_SUBJMAX ? len : ENTRY_SUBJMAX;
+}
+
+static void fill_pool(void)
+{
+        size_t nwords = sizeof(words) / sizeof(words[0]);
+        size_t len = 0;
+
+        while (len < GEN_POOLSIZE) {
+                const char *word = words[next_rand() % nwords];
+                size_t word_len = strlen(word);
+
+                if (len + word_len + 1 > GEN_POOLSIZE)
+                        word_len = GEN_POOLSIZE - len - 1;
+
+                memcpy(pool + len, word, word_len);
+                len += word_len;
+                pool[len++] = ' ';
+        }
+}
+
+static bool put_line(FILE *fp, const char *date, bool status, long len)
+{
+        char line[SUBJOFFSET];
+        size_t from = next_rand() % (GEN_POOLSIZE - ENTRY_SUBJMAX);
+
+        /* Subject starts with a word and never with a space. */
+        while (from > 0 && pool[from - 1] != ' ')
+                --from;
+
+        memcpy(line, date, DATEOFFSET);
+        line[DATEOFFSET] = ' ';
+        line[STATOFFSET] = status ? '+' : '-';
+        line[STATOFFSET + 1] = ' ';
+
+        /* Cut on a space would leave a trailing blank. */
+        bool blank = pool[from + len - 1] == ' ';
+
+        return put(fp, line, SUBJOFFSET) &&
+                put(fp, pool + from, len - blank) &&
+                put(fp, blank ? "x\n" : "\n", blank + 1);
+}
+
+static bool put_bad_line(FILE *fp, const char *date)
+{
+        char line[LINESIZE];
+        int len = 0;
+
+        switch (next_rand() % 5) {
+                case 0:
+                        /* Day out of range. */
+                        len = snprintf(line, sizeof(line), "32%s + %s\n",
+                                        date + 2, "bad day");
+                        break;
+
+                case 1:
+                        /* Status which is neither done nor undone. */
+                        len = snprintf(line, sizeof(line), "%s ? %s\n", date,
+                                        "bad status");
+                        break;
+
+                case 2:
+                        /* Line cut before the subject. */
+                        len = snprintf(line, sizeof(line), "%.*s\n",
+                                        STATOFFSET - 3, date);
+                        break;
+
+                case 3:
+                        /* Separators replaced. */
+                        len = snprintf(line, sizeof(line),
+                                        "%.2s/%.2s/%s - bad separators\n",
+                                        date, date + 3, date + 6);
+                        break;
+
+                default:
+                        len = snprintf(line, sizeof(line), "\n");
+                        break;
+        }
+
+        return put(fp, line, len);
+}
+
+static bool put(FILE *fp, const char *data, size_t len)
+{
+        if (out_len + len > GEN_BUFSIZE && !flush_out(fp))
+                return false;
+
+        memcpy(out + out_len, data, len);
+        out_len += len;
+        return true;
+}
+
+static bool flush_out(FILE *fp)
+{
+        bool ok = fwrite(out, 1, out_len, fp) == out_len;
+
+        out_len = 0;
+        return ok && fflush(fp) == 0;
+}
+
+static Date next_day(Date date)
+{
+        unsigned d = DATE_DAY(date);
+        unsigned m = DATE_MONTH(date);
+        unsigned y = DATE_YEAR(date);
+        Date next = date;
+
+        if (date_make(d + 1, m, y, &next) || date_make(1, m + 1, y, &next) ||
+                        date_make(1, 1, y + 1, &next))
+                return next;
+
+        /* Last supported day repeats. */
+        return date;
+}